@@ -35,6 +35,9 @@
 #include "vcml/logging/log_file.h"
 #include "vcml/logging/log_stream.h"
 #include "vcml/logging/log_term.h"
+#include "vcml/logging/log_async.h"
+#include "vcml/logging/trace_format.h"
+#include "vcml/logging/trace_bin.h"
 
 #include "vcml/properties/property_base.h"
 #include "vcml/properties/property.h"
@@ -47,6 +50,7 @@
 #include "vcml/debugging/elf_reader.h"
 #include "vcml/debugging/target.h"
 #include "vcml/debugging/loader.h"
+#include "vcml/debugging/condition.h"
 #include "vcml/debugging/subscriber.h"
 #include "vcml/debugging/suspender.h"
 #include "vcml/debugging/rspserver.h"
@@ -27,7 +27,15 @@ namespace vcml {
 
     typedef function<void(int)> aio_handler;
 
-    void aio_notify(int fd, aio_handler handler);
+    enum aio_policy {
+        AIO_LEVEL, // handler is called as long as data is available
+        AIO_EDGE,  // handler is called once per arrival and must drain fd
+    };
+
+    // Handlers are invoked from a dedicated aio thread without any aio locks
+    // held, so they may call aio_notify and aio_cancel themselves. Once
+    // aio_cancel returns, the handler of that fd is no longer executing.
+    void aio_notify(int fd, aio_handler handler, aio_policy p = AIO_LEVEL);
     void aio_cancel(int fd);
 
 }
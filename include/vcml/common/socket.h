@@ -37,7 +37,17 @@ namespace vcml {
         atomic<int> m_conn;
         thread      m_async;
 
+        vector<u8>  m_rxbuf;
+        size_t      m_rxpos;
+        size_t      m_rxlen;
+
+        size_t fill(void* data, size_t size);
+
     public:
+        enum : size_t {
+            RXBUF_SIZE = 64 * KiB,
+        };
+
         u16         port() const { return m_port; }
         const char* host() const { return m_host.c_str(); }
         const char* peer() const { return m_peer.c_str(); }
@@ -48,6 +58,10 @@ namespace vcml {
         bool is_listening() const { return m_socket >= 0; }
         bool is_connected() const { return m_conn >= 0; }
 
+        int fd() const { return m_conn; }
+
+        size_t buffered() const { return m_rxlen - m_rxpos; }
+
         socket();
         socket(u16 port);
         socket(const string& host, u16 port);
@@ -87,6 +101,9 @@ namespace vcml {
     }
 
     inline int socket::recv_char() {
+        if (m_rxpos < m_rxlen)
+            return (char)m_rxbuf[m_rxpos++];
+
         char x = 0;
         recv(&x, sizeof(x));
         return x;
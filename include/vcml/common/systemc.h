@@ -298,20 +298,28 @@ namespace vcml {
 
     void on_end_of_elaboration(function<void(void)> callback);
     void on_start_of_simulation(function<void(void)> callback);
+    void on_end_of_simulation(function<void(void)> callback);
 
     void on_each_delta_cycle(function<void(void)> callback);
     void on_each_time_step(function<void(void)> callback);
 
+    // callbacks with a pending flag are only invoked while it is set
+    void on_each_delta_cycle(function<void(void)> callback,
+                             const atomic<bool>& pending);
+    void on_each_time_step(function<void(void)> callback,
+                           const atomic<bool>& pending);
+
+    u64 sim_delta_cycles();
+    u64 sim_time_steps();
+
     class timer
     {
-    public:
-        struct event {
-            timer* owner;
-            sc_time timeout;
-        };
+        friend class timer_wheel;
 
+    public:
         size_t count() const { return m_triggers; }
         const sc_time& timeout() const { return m_timeout; }
+        bool is_pending() const { return m_slot != NO_SLOT; }
 
         timer(function<void(timer&)> cb);
         timer(const sc_time& delta, function<void(timer&)> cb):
@@ -327,15 +335,24 @@ namespace vcml {
         void reset(const sc_time& delta);
 
     private:
+        enum : size_t { NO_SLOT = ~(size_t)0 };
+
         size_t m_triggers;
         sc_time m_timeout;
-        event* m_event;
+        size_t m_slot;
+        timer* m_prev;
+        timer* m_next;
         function<void(timer&)> m_cb;
+
+        // disabled
+        timer(const timer&);
+        timer& operator = (const timer&);
     };
 
     void sc_async(function<void(void)> job);
     void sc_progress(const sc_time& delta);
     void sc_sync(function<void(void)> job);
+    void sc_post(function<void(void)> job);
 
     bool sc_is_async();
 
@@ -31,6 +31,9 @@ namespace vcml {
     void thctl_exit_critical();
     void thctl_suspend();
 
+    void thctl_enter_resource();
+    void thctl_exit_resource();
+
     class thctl_guard
     {
     private:
@@ -52,6 +55,84 @@ namespace vcml {
             thctl_exit_critical();
     }
 
+    // Protects a single resource, e.g. a framebuffer or a memory region,
+    // against concurrent access from threads other than SystemC. Readers do
+    // not stop the simulation and only wait for writers of the same resource.
+    // Resources created with sysc_access also get modified by SystemC without
+    // taking a guard; writers from other threads then wait for SystemC to
+    // pause at the next delta cycle. Writers of other resources never pause
+    // SystemC. Guards must not be held across SystemC wait calls.
+    class thctl_resource
+    {
+    private:
+        mutex m_mtx;
+        condition_variable m_cv;
+        size_t m_readers;
+        size_t m_waiting;
+        bool m_writer;
+        const bool m_sysc_access;
+
+    public:
+        bool has_sysc_access() const { return m_sysc_access; }
+
+        explicit thctl_resource(bool sysc_access = false);
+        ~thctl_resource() = default;
+
+        thctl_resource(const thctl_resource&) = delete;
+        thctl_resource& operator = (const thctl_resource&) = delete;
+
+        void lock_shared();
+        void unlock_shared();
+
+        void lock();
+        void unlock();
+    };
+
+    class thctl_shared_guard
+    {
+    private:
+        thctl_resource& m_res;
+
+    public:
+        thctl_shared_guard(thctl_resource& res);
+        ~thctl_shared_guard();
+    };
+
+    inline thctl_shared_guard::thctl_shared_guard(thctl_resource& res):
+        m_res(res) {
+        m_res.lock_shared();
+    }
+
+    inline thctl_shared_guard::~thctl_shared_guard() {
+        m_res.unlock_shared();
+    }
+
+    class thctl_exclusive_guard
+    {
+    private:
+        thctl_resource& m_res;
+        bool m_pausing;
+
+    public:
+        thctl_exclusive_guard(thctl_resource& res);
+        ~thctl_exclusive_guard();
+    };
+
+    inline thctl_exclusive_guard::thctl_exclusive_guard(thctl_resource& res):
+        m_res(res),
+        m_pausing(res.has_sysc_access() && !thctl_is_sysc_thread() &&
+                  !thctl_is_in_critical()) {
+        if (m_pausing)
+            thctl_enter_resource();
+        m_res.lock();
+    }
+
+    inline thctl_exclusive_guard::~thctl_exclusive_guard() {
+        m_res.unlock();
+        if (m_pausing)
+            thctl_exit_resource();
+    }
+
 }
 
 #endif
@@ -55,6 +55,15 @@
 #define VCML_DECL_PACKED \
     __attribute__ ((packed))
 
+#define VCML_DECL_ALWAYS_INLINE \
+    __attribute__ ((always_inline))
+
+// GCC can forward variadic arguments from always_inline functions, which
+// allows cheap inline checks in front of printf-style functions
+#if defined(__GNUC__) && !defined(__clang__)
+#define VCML_HAVE_VA_ARG_PACK
+#endif
+
 namespace vcml {
 
     typedef uint8_t  u8;
@@ -40,6 +40,7 @@ namespace vcml {
 
     u64 realtime_us();
     u64 timestamp_us();
+    u64 timestamp_ns();
 
     size_t fd_peek(int fd, time_t timeout_ms = 0ull);
     size_t fd_read(int fd, void* buffer, size_t buflen);
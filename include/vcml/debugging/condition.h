@@ -0,0 +1,116 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+#ifndef VCML_DEBUGGING_CONDITION_H
+#define VCML_DEBUGGING_CONDITION_H
+
+#include "vcml/common/types.h"
+#include "vcml/common/report.h"
+
+namespace vcml { namespace debugging {
+
+    struct cpureg;
+    class target;
+
+    // A breakpoint condition is a list of programs in gdb agent expression
+    // bytecode; it holds if any of them evaluates to a non-zero value. An
+    // empty condition always holds. Register operands are resolved to
+    // cpuregs once when a program is added, so evaluation only touches the
+    // debug interfaces of the target.
+    class condition
+    {
+    public:
+        enum opcode : u8 {
+            OP_ADD = 0x02,
+            OP_SUB = 0x03,
+            OP_MUL = 0x04,
+            OP_DIV_SIGNED = 0x05,
+            OP_DIV_UNSIGNED = 0x06,
+            OP_REM_SIGNED = 0x07,
+            OP_REM_UNSIGNED = 0x08,
+            OP_LSH = 0x09,
+            OP_RSH_SIGNED = 0x0a,
+            OP_RSH_UNSIGNED = 0x0b,
+            OP_LOG_NOT = 0x0e,
+            OP_BIT_AND = 0x0f,
+            OP_BIT_OR = 0x10,
+            OP_BIT_XOR = 0x11,
+            OP_BIT_NOT = 0x12,
+            OP_EQUAL = 0x13,
+            OP_LESS_SIGNED = 0x14,
+            OP_LESS_UNSIGNED = 0x15,
+            OP_EXT = 0x16,
+            OP_REF8 = 0x17,
+            OP_REF16 = 0x18,
+            OP_REF32 = 0x19,
+            OP_REF64 = 0x1a,
+            OP_IF_GOTO = 0x20,
+            OP_GOTO = 0x21,
+            OP_CONST8 = 0x22,
+            OP_CONST16 = 0x23,
+            OP_CONST32 = 0x24,
+            OP_CONST64 = 0x25,
+            OP_REG = 0x26,
+            OP_END = 0x27,
+            OP_DUP = 0x28,
+            OP_POP = 0x29,
+            OP_ZERO_EXT = 0x2a,
+            OP_SWAP = 0x2b,
+            OP_PICK = 0x32,
+            OP_ROT = 0x33,
+        };
+
+        enum : size_t {
+            MAX_STACK = 64,
+            MAX_STEPS = 4096,
+        };
+
+    private:
+        struct program {
+            vector<u8> code;
+            vector<const cpureg*> regs;
+        };
+
+        vector<program> m_programs;
+
+        static bool execute(const program& prog, target& tgt, u64& result);
+
+    public:
+        bool is_empty() const { return m_programs.empty(); }
+        size_t size() const { return m_programs.size(); }
+
+        condition();
+
+        void clear() { m_programs.clear(); }
+
+        // adds a gdb agent expression, register numbers are mapped to
+        // cpuregs using the given lookup function; returns false if the
+        // bytecode is malformed or uses unsupported operations
+        bool add_agent_expr(const vector<u8>& code,
+            const function<const cpureg*(u64)>& lookup);
+
+        // adds a textual expression of the form "<lhs> [<op> <rhs>]" where
+        // <op> is one of == != < <= > >= & and operands are numbers, cpureg
+        // names or memory references u8/u16/u32/u64[<operand>]
+        bool add_expression(const string& expr, const target& tgt);
+
+        bool evaluate(target& tgt) const;
+    };
+
+}}
+
+#endif
@@ -51,17 +51,41 @@ namespace vcml { namespace debugging {
                      private suspender
     {
     private:
-        target&        m_target;
-        const gdbarch* m_target_arch;
-        string         m_target_xml;
-        gdb_status     m_status;
-        gdb_status     m_default;
-
-        vector<const cpureg*> m_cpuregs;
-        unordered_map<u64, const cpureg*> m_allregs;
+        vector<target*> m_targets;
+        target*         m_gtarget;
+        target*         m_ctarget;
+        atomic<target*> m_stopped;
+        const gdbarch*  m_target_arch;
+        string          m_target_xml;
+        gdb_status      m_status;
+        gdb_status      m_default;
+        atomic<bool>    m_nonstop;
+
+        mutex              m_status_mtx;
+        condition_variable m_status_cv;
+        int                m_signal;
+
+        mutex           m_stop_mtx;
+        queue<string>   m_stops;
+        bool            m_notified;
+
+        unordered_map<const target*, vector<const cpureg*>> m_cpuregs;
+        unordered_map<const target*,
+                      unordered_map<u64, const cpureg*>> m_allregs;
 
         void update_status(gdb_status status);
 
+        u64 thread_id(const target& tgt) const;
+        target* find_thread(i64 tid) const;
+
+        string stop_reply(const target& tgt, int signal) const;
+        void notify_stop(target& tgt);
+        void queue_stop(const string& reply);
+
+        void set_nonstop(bool nonstop);
+        void handle_signal(int signal);
+        string run_until_stop(gdb_status status);
+
         virtual void notify_step_complete(target& tgt) override;
 
         virtual void notify_breakpoint_hit(const breakpoint& bp) override;
@@ -74,6 +98,9 @@ namespace vcml { namespace debugging {
                                              u64 newval) override;
 
         const cpureg* lookup_cpureg(unsigned int gdbno);
+        bool parse_condition(const char* command, const target* tgt,
+                             condition& cond);
+        bool parse_breakpoint_type(u64 type, vcml_access& prot);
 
         typedef string (gdbserver::*handler)(const char*);
         std::map<char, handler> m_handler;
@@ -91,8 +118,10 @@ namespace vcml { namespace debugging {
         string handle_unknown(const char* command);
 
         string handle_query(const char* command);
+        string handle_set(const char* command);
         string handle_rcmd(const char* command);
         string handle_xfer(const char* command);
+        string handle_thread_info(const char* command);
         string handle_step(const char* command);
         string handle_continue(const char* command);
         string handle_detach(const char* command);
@@ -111,7 +140,10 @@ namespace vcml { namespace debugging {
 
         string handle_exception(const char*);
         string handle_thread(const char*);
+        string handle_thread_alive(const char*);
+        string handle_vcmd(const char*);
         string handle_vcont(const char*);
+        string handle_vstopped(const char*);
 
     public:
         enum : size_t {
@@ -123,10 +155,15 @@ namespace vcml { namespace debugging {
         bool is_stepping() const { return m_status == GDB_STEPPING; }
         bool is_running()  const { return m_status == GDB_RUNNING; }
         bool is_killed()   const { return m_status == GDB_KILLED; }
+        bool is_nonstop()  const { return m_nonstop; }
+
+        const vector<target*>& targets() const { return m_targets; }
 
         gdbserver() = delete;
         gdbserver(const gdbserver&) = delete;
         gdbserver(u16 port, target& stub, gdb_status status = GDB_STOPPED);
+        gdbserver(u16 port, const vector<target*>& targets,
+                  gdb_status status = GDB_STOPPED);
         virtual ~gdbserver();
 
         virtual string handle_command(const string& command) override;
@@ -23,6 +23,7 @@
 #include "vcml/common/strings.h"
 #include "vcml/common/report.h"
 #include "vcml/common/socket.h"
+#include "vcml/common/aio.h"
 
 namespace vcml { namespace debugging {
 
@@ -33,14 +34,19 @@ namespace vcml { namespace debugging {
 
     private:
         bool m_echo;
+        bool m_noack;
         u16 m_port;
         socket m_sock;
+        string m_txbuf;
 
         atomic<bool> m_running;
 
         mutex m_mutex;
+        mutex m_txmutex;
         thread m_thread;
 
+        int m_signal_fd;
+
         std::map<string, handler> m_handlers;
 
         // disabled
@@ -55,14 +61,20 @@ namespace vcml { namespace debugging {
 
         void echo(bool e = true) { m_echo = e; }
 
+        bool is_noack() const { return m_noack; }
+
         rspserver(u16 port);
         virtual ~rspserver();
 
         void   send_packet(const string& s);
         void   send_packet(const char* format, ...);
+        void   send_notification(const string& s);
         string recv_packet();
         int    recv_signal(time_t timeoutms = ~0ull);
 
+        void notify_signal(function<void(int)> handler);
+        void cancel_signal();
+
         void listen();
         void disconnect();
 
@@ -78,6 +90,9 @@ namespace vcml { namespace debugging {
         void register_handler(const char* command, handler handler);
         void unregister_handler(const char* command);
 
+        static void hex_encode(string& s, const u8* data, size_t size);
+        static void hex_encode(string& s, u64 val, size_t size);
+
         static const char* ERR_COMMAND;  // malformed command
         static const char* ERR_PARAM;    // parameter has invalid value
         static const char* ERR_INTERNAL; // internal error
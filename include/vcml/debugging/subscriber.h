@@ -24,6 +24,7 @@
 #include "vcml/common/range.h"
 
 #include "vcml/debugging/symtab.h"
+#include "vcml/debugging/condition.h"
 
 namespace vcml { namespace debugging {
 
@@ -52,12 +53,20 @@ namespace vcml { namespace debugging {
     class breakpoint
     {
     private:
+        struct subscription {
+            subscriber* subscr;
+            condition cond;
+            u64 ignore;
+        };
+
         target& m_target;
         u64 m_id;
         u64 m_addr;
         u64 m_count;
         const symbol* m_func;
-        vector<subscriber*> m_subscribers;
+        vector<subscription> m_subscribers;
+
+        subscription* find_subscription(const subscriber* s);
 
     public:
         target& owner() const { return m_target; }
@@ -77,7 +86,11 @@ namespace vcml { namespace debugging {
 
         void notify();
 
+        // subscribers with a condition or an ignore count only get notified
+        // once their condition holds and the ignore count has run down;
+        // subscribing again replaces condition and ignore count
         bool subscribe(subscriber* s);
+        bool subscribe(subscriber* s, const condition& cond, u64 ignore = 0);
         bool unsubscribe(subscriber* s);
     };
 
@@ -94,7 +107,7 @@ namespace vcml { namespace debugging {
         vector<subscriber*> m_subscribers_w;
 
     public:
-        target& owner() { return m_target; }
+        target& owner() const { return m_target; }
         u64 id() const { return m_id; }
         u64 hit_count() const { return m_count; }
         const range& address() const { return m_addr; }
@@ -81,10 +81,49 @@ namespace vcml { namespace debugging {
         symtab m_symbols;
 
         vector<subscriber*> m_steppers;
+        atomic<bool> m_halted;
+
+        thctl_resource m_dbgres;
 
         vector<breakpoint*> m_breakpoints;
         vector<watchpoint*> m_watchpoints;
 
+        // open-addressed hash table of all breakpoints, indexed by address
+        struct bpslot {
+            u64 addr;
+            breakpoint* bp;
+        };
+
+        vector<bpslot> m_bptable;
+        unsigned int m_bpshift;
+
+        // interval index over watchpoints sorted by start address, with a
+        // hashed page bitmap in front to reject unwatched pages quickly
+        struct wpindex {
+            enum : u64 {
+                PAGE_BITS = 12,
+                FILTER_BITS = 4096,
+            };
+
+            vector<watchpoint*> wps;
+            vector<u64> ends;
+            array<u64, FILTER_BITS / 64> filter;
+
+            static u64 page_bit(u64 page);
+
+            bool is_filtered(const range& addr) const;
+            void build(const vector<watchpoint*>& all, vcml_access prot);
+
+            template <typename FUNC>
+            void lookup(const range& addr, FUNC func) const;
+        };
+
+        wpindex m_wpindex_r;
+        wpindex m_wpindex_w;
+
+        void update_breakpoints();
+        void update_watchpoints();
+
         static unordered_map<string, target*> s_targets;
 
     protected:
@@ -147,8 +186,14 @@ namespace vcml { namespace debugging {
         const vector<breakpoint*>& breakpoints() const;
         const vector<watchpoint*>& watchpoints() const;
 
+        bool is_breakpoint(u64 addr) const;
+        breakpoint* find_breakpoint(u64 addr) const;
+
         const breakpoint* lookup_breakpoint(u64 addr);
         const breakpoint* insert_breakpoint(u64 addr, subscriber* subscr);
+        const breakpoint* insert_breakpoint(u64 addr, subscriber* subscr,
+                                            const condition& cond,
+                                            u64 ignore = 0);
         bool remove_breakpoint(const breakpoint* bp, subscriber* subscr);
         bool remove_breakpoint(u64 addr, subscriber* subscr);
 
@@ -157,8 +202,18 @@ namespace vcml { namespace debugging {
 
         bool is_stepping() const;
         void request_singlestep(subscriber* subscr);
+        void cancel_singlestep(subscriber* subscr);
         void notify_singlestep();
 
+        bool is_halted() const;
+        void request_halt();
+        void request_resume();
+
+        // debuggers running outside of SystemC may read the registers of a
+        // halted target under a thctl_shared_guard on this, all other
+        // accesses need an exclusive guard
+        thctl_resource& debug_resource() { return m_dbgres; }
+
         static vector<target*> all();
         static target* find(const string& name);
     };
@@ -199,6 +254,24 @@ namespace vcml { namespace debugging {
         return m_watchpoints;
     }
 
+    inline breakpoint* target::find_breakpoint(u64 addr) const {
+        if (m_breakpoints.empty())
+            return nullptr;
+
+        const size_t mask = m_bptable.size() - 1;
+        size_t idx = (addr * 0x9e3779b97f4a7c15ull) >> m_bpshift;
+        for (; m_bptable[idx].bp != nullptr; idx = (idx + 1) & mask) {
+            if (m_bptable[idx].addr == addr)
+                return m_bptable[idx].bp;
+        }
+
+        return nullptr;
+    }
+
+    inline bool target::is_breakpoint(u64 addr) const {
+        return find_breakpoint(addr) != nullptr;
+    }
+
     inline bool target::is_stepping() const {
         return !m_steppers.empty();
     }
@@ -207,6 +280,22 @@ namespace vcml { namespace debugging {
         stl_add_unique(m_steppers, subscr);
     }
 
+    inline void target::cancel_singlestep(subscriber* subscr) {
+        stl_remove_erase(m_steppers, subscr);
+    }
+
+    inline bool target::is_halted() const {
+        return m_halted;
+    }
+
+    inline void target::request_halt() {
+        m_halted = true;
+    }
+
+    inline void target::request_resume() {
+        m_halted = false;
+    }
+
 }}
 
 #endif
@@ -0,0 +1,87 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef VCML_LOG_ASYNC_H
+#define VCML_LOG_ASYNC_H
+
+#include "vcml/common/types.h"
+#include "vcml/common/strings.h"
+#include "vcml/logging/logger.h"
+
+namespace vcml {
+
+    enum log_overflow {
+        LOG_OVERFLOW_BLOCK = 0,   // wait for the writer to make room
+        LOG_OVERFLOW_DROP_OLDEST, // discard the oldest queued message
+        LOG_OVERFLOW_COUNT_DROPS, // discard the new message
+    };
+
+    // Wraps another logger and moves its (potentially slow) output into a
+    // separate writer thread. The wrapped logger is owned by log_async and
+    // no longer receives messages directly. Messages are copied into a
+    // bounded queue and written in batches. Dropped messages are counted and
+    // reported through the wrapped logger. Error messages are written
+    // synchronously, so that they are not lost if the simulation aborts.
+    class log_async: public logger
+    {
+    private:
+        logger*      m_logger;
+        size_t       m_capacity;
+        log_overflow m_policy;
+
+        mutex              m_mtx;
+        condition_variable m_cv_data;
+        condition_variable m_cv_space;
+        condition_variable m_cv_done;
+        deque<logmsg>      m_queue;
+
+        bool m_busy;
+        bool m_running;
+        u64  m_dropped;
+        u64  m_reported;
+
+        thread m_writer;
+
+        void report_drops(const logmsg& next, u64 dropped);
+        void writer();
+
+        static mutex s_mtx;
+        static vector<log_async*> s_loggers;
+
+    public:
+        logger* wrapped() const { return m_logger; }
+        size_t capacity() const { return m_capacity; }
+        log_overflow policy() const { return m_policy; }
+
+        u64 dropped();
+
+        log_async() = delete;
+        log_async(logger* wrapped, size_t capacity = 4096,
+                  log_overflow policy = LOG_OVERFLOW_BLOCK);
+        virtual ~log_async();
+
+        virtual void write_log(const logmsg& msg) override;
+
+        void flush();
+
+        static void flush_all();
+    };
+
+}
+
+#endif
@@ -85,6 +85,8 @@ namespace vcml {
 
     class logger
     {
+        friend class log_async;
+
     private:
         log_level m_min;
         log_level m_max;
@@ -103,6 +105,11 @@ namespace vcml {
         static size_t trace_curr_indent;
         static vector<logger*> loggers[NUM_LOG_LEVELS];
 
+        // updated when loggers (un)register, so that would_log only needs a
+        // single relaxed load instead of looking at the logger lists
+        static atomic<bool> listening[NUM_LOG_LEVELS];
+        static mutex registry_mtx;
+
     public:
         inline void set_level(log_level max);
         void set_level(log_level min, log_level max);
@@ -153,6 +160,8 @@ namespace vcml {
         static size_t trace_name_length;
         static size_t trace_indent_incr;
 
+        static string trace_prefix(trace_direction direction);
+
         static void print_prefix(ostream& os, const logmsg& msg);
         static void print_logmsg(ostream& os, const logmsg& msg);
 
@@ -165,7 +174,7 @@ namespace vcml {
     }
 
     inline bool logger::would_log(log_level lvl) {
-        return !loggers[lvl].empty();
+        return listening[lvl].load(std::memory_order_relaxed);
     }
 
     template <typename PAYLOAD>
@@ -208,23 +217,10 @@ namespace vcml {
         trace_msg<PAYLOAD> msg(sender.name(), direction, tx);
         msg.time_offset = dt;
 
-        stringstream ss;
-        if (direction == TRACE_FW)
-            trace_curr_indent += trace_indent_incr;
-        if (direction >= TRACE_FW)
-            ss << string(trace_curr_indent, ' ') << ">> ";
-        if (direction <= TRACE_BW)
-            ss << string(trace_curr_indent, ' ') << "<< ";
-        if (direction == TRACE_BW) {
-            if (trace_curr_indent >= trace_indent_incr)
-                trace_curr_indent -= trace_indent_incr;
-            else
-                trace_curr_indent = 0;
-        }
-
+        string prefix = trace_prefix(direction);
         vector<string> lines = split(to_string(tx), '\n');
         for (auto line : lines)
-            msg.lines.push_back(ss.str() + line);
+            msg.lines.push_back(prefix + line);
 
         for (auto logger : loggers[LOG_TRACE])
             logger->write_trace(msg);
@@ -246,6 +242,22 @@ namespace vcml {
     // replace them instead with first-grade functions. However, this will also
     // remove log message source information.
 #ifndef VCML_OMIT_LOGGING_SOURCE
+    void log_publish(log_level level, const char* file, int line,
+                     const char* format, ...) VCML_DECL_PRINTF(4, 5);
+
+#ifdef VCML_HAVE_VA_ARG_PACK
+    // inlined into the caller, so suppressed messages only cost the level
+    // check and never set up a variadic call
+    static inline void log_tagged(log_level level, const char* file, int line,
+                                  const char* format, ...)
+        VCML_DECL_PRINTF(4, 5) VCML_DECL_ALWAYS_INLINE;
+
+    static inline void log_tagged(log_level lvl, const char* file, int line,
+                                  const char* fmt, ...) {
+        if (logger::would_log(lvl))
+            log_publish(lvl, file, line, fmt, __builtin_va_arg_pack());
+    }
+#else
     static void log_tagged(log_level level, const char* file, int line,
                            const char* format, ...) VCML_DECL_PRINTF(4, 5);
 
@@ -257,6 +269,7 @@ namespace vcml {
             va_end(args);
         }
     }
+#endif
 
 #define log_error(...) \
     log_tagged(::vcml::LOG_ERROR, __FILE__, __LINE__, __VA_ARGS__)
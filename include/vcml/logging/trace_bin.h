@@ -0,0 +1,129 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+#ifndef VCML_TRACE_BIN_H
+#define VCML_TRACE_BIN_H
+
+#include "vcml/common/types.h"
+#include "vcml/common/report.h"
+#include "vcml/common/systemc.h"
+
+#include "vcml/logging/logger.h"
+#include "vcml/logging/trace_format.h"
+
+namespace vcml {
+
+    // Records TLM transactions as fixed size binary records into per-thread
+    // lock-free ring buffers, which are drained into a file by a background
+    // writer thread. Use the vcml-tracedump utility to convert the file into
+    // text or CSV.
+    class trace_bin
+    {
+    public:
+        enum : size_t {
+            RING_SIZE = 16 * KiB, // records per producer thread
+            MAX_INFLIGHT = 256,   // outstanding forward records per thread
+        };
+
+    private:
+        struct inflight {
+            const tlm_generic_payload* tx;
+            u32 socket;
+            u64 time;
+        };
+
+        struct ring {
+            vector<trace_record> records;
+            atomic<u64> head;
+            atomic<u64> tail;
+            unordered_map<const void*, u32> ids;
+            vector<inflight> pending;
+
+            ring();
+        };
+
+        string m_path;
+        FILE*  m_file;
+        u64    m_gen;
+
+        mutex m_mtx;
+        vector<ring*> m_rings;
+        unordered_map<string, u32> m_ids;
+
+        mutex m_drain_mtx;
+        mutex m_wait_mtx;
+        condition_variable m_wait_cv;
+
+        atomic<bool> m_running;
+        atomic<u64> m_records;
+        thread m_writer;
+
+        ring* local_ring();
+        u32 socket_id(ring* r, const void* sender, const char* name);
+
+        trace_record& claim(ring* r);
+        void commit(ring* r);
+
+        void drain();
+        void writer();
+
+        static trace_bin* s_active;
+
+    public:
+        const char* path() const { return m_path.c_str(); }
+        u64 records() const { return m_records; }
+
+        trace_bin() = delete;
+        trace_bin(const string& path);
+        virtual ~trace_bin();
+
+        trace_bin(const trace_bin&) = delete;
+        trace_bin& operator = (const trace_bin&) = delete;
+
+        void flush();
+
+        void record(trace_direction dir, const void* sender, const char* name,
+                    const tlm_generic_payload& tx, const sc_time& dt);
+
+        static trace_bin* active() { return s_active; }
+
+        template <typename SENDER, typename PAYLOAD>
+        static void trace(trace_direction dir, const SENDER& sender,
+                          const PAYLOAD& tx, const sc_time& dt);
+
+        template <typename SENDER>
+        static void trace(trace_direction dir, const SENDER& sender,
+                          const tlm_generic_payload& tx, const sc_time& dt);
+    };
+
+    template <typename SENDER, typename PAYLOAD>
+    inline void trace_bin::trace(trace_direction dir, const SENDER& sender,
+                                 const PAYLOAD& tx, const sc_time& dt) {
+        // only TLM transactions are recorded in binary traces
+    }
+
+    template <typename SENDER>
+    inline void trace_bin::trace(trace_direction dir, const SENDER& sender,
+                                 const tlm_generic_payload& tx,
+                                 const sc_time& dt) {
+        if (s_active != nullptr)
+            s_active->record(dir, &sender, sender.name(), tx, dt);
+    }
+
+}
+
+#endif
@@ -0,0 +1,86 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+#ifndef VCML_TRACE_FORMAT_H
+#define VCML_TRACE_FORMAT_H
+
+#include "vcml/common/types.h"
+
+// This header describes the on-disk format of binary transaction traces. It
+// must not depend on SystemC, so that offline tools can read traces without
+// linking against the simulator.
+
+namespace vcml {
+
+    enum trace_record_kind : u8 {
+        TRACE_RECORD_NAME = 0,      // first chunk of a socket name
+        TRACE_RECORD_NAME_CONT = 1, // continuation of a socket name
+        TRACE_RECORD_FW = 2,        // transaction entering a socket
+        TRACE_RECORD_BW = 3,        // transaction returning from a socket
+    };
+
+    enum trace_record_flags : u8 {
+        TRACE_FLAG_DEBUG = 1 << 0,
+        TRACE_FLAG_NODMI = 1 << 1,
+        TRACE_FLAG_SYNC = 1 << 2,
+        TRACE_FLAG_INSN = 1 << 3,
+        TRACE_FLAG_EXCL = 1 << 4,
+        TRACE_FLAG_LOCK = 1 << 5,
+        TRACE_FLAG_NOINDENT = 1 << 7,
+    };
+
+    struct trace_file_header {
+        char magic[8];      // "VCMLTRC\0"
+        u32  version;       // TRACE_FORMAT_VERSION
+        u32  record_size;   // sizeof(trace_record)
+        u64  resolution;    // femtoseconds per time unit
+    };
+
+    struct trace_record {
+        u8  kind;           // trace_record_kind
+        u8  command;        // tlm_command
+        i8  response;       // tlm_response_status
+        u8  flags;          // trace_record_flags
+        u32 socket;         // socket id, defined by preceding name records
+
+        union {
+            struct {
+                u64 time;       // time stamp including local offset
+                u64 delta;      // delta cycle count
+                u64 addr;       // transaction address
+                u32 size;       // transaction data length
+                u32 cpuid;      // sideband cpu id
+                u64 latency;    // time since forward record, 0 for forward
+                u8  data[16];   // leading data bytes of the transaction
+            };
+
+            char name[56];      // socket name chunk, zero padded
+        };
+    };
+
+    enum : u32 {
+        TRACE_FORMAT_VERSION = 1,
+    };
+
+    static_assert(sizeof(trace_record) == 64, "trace record size changed");
+    static_assert(sizeof(trace_file_header) == 24, "trace header changed");
+
+    static const char TRACE_FORMAT_MAGIC[8] = "VCMLTRC";
+
+}
+
+#endif
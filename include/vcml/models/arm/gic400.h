@@ -151,6 +151,11 @@ namespace vcml { namespace arm {
             u32 write_ICFGR(u32 value);
             u32 write_ICFGR_SPI(u32 value, size_t idx);
 
+            u8  write_IPRIORITY_SGI(u8 value, size_t idx);
+            u8  write_IPRIORITY_PPI(u8 value, size_t idx);
+            u8  write_IPRIORITY_SPI(u8 value, size_t idx);
+            u8  write_ITARGETS_SPI(u8 value, size_t idx);
+
             u32 write_SGIR(u32 value);
             u8  write_SPENDSGIR(u8 value, size_t idx);
             u8  write_CPENDSGIR(u8 value, size_t idx);
@@ -208,6 +213,9 @@ namespace vcml { namespace arm {
 
             void set_sgi_pending(u8 value, unsigned int sgi, unsigned int cpu,
                                  bool set);
+
+            void send_sgi(unsigned int sgi, unsigned int src_cpu,
+                          unsigned int targets);
         };
 
         class cpuif: public peripheral
@@ -393,6 +401,7 @@ namespace vcml { namespace arm {
         u8 get_irq_priority(unsigned int cpu, unsigned int irq);
 
         void update(bool virt = false);
+        void update_cpus(unsigned int mask, bool virt = false);
 
         virtual void end_of_elaboration() override;
         virtual void irq_transport(const irq_target_socket& socket,
@@ -402,10 +411,36 @@ namespace vcml { namespace arm {
         void handle_spi(unsigned int idx, irq_payload& irq);
 
     private:
+        static const unsigned int NPRIO = 256;
+        static const unsigned int NIRQ_WORDS = (NIRQ + 63) / 64;
+        static const unsigned int NPRIO_WORDS = NPRIO / 64;
+
         unsigned int m_irq_num;
         unsigned int m_cpu_num;
 
         irq_state m_irq_state[NIRQ+NRES];
+
+        // per-cpu bitmap of irqs that are enabled, pending, not active and
+        // targeted at that cpu; the same irqs are also kept in a bitmap per
+        // priority (allocated on first use), summarized by its non-empty
+        // words and by the set of priorities in use
+        u64 m_eligible[NCPU][NIRQ_WORDS];
+        u8  m_eligible_prio[NCPU][NIRQ];
+        vector<u64> m_prio_irqs[NCPU][NPRIO];
+        u32 m_prio_words[NCPU][NPRIO];
+        u64 m_prio_used[NCPU][NPRIO_WORDS];
+
+        static_assert(NIRQ_WORDS <= 32, "irq word summary too narrow");
+
+        bool is_irq_eligible(unsigned int irq, unsigned int cpu);
+        void refresh_irq_cpu(unsigned int irq, unsigned int cpu);
+        void refresh_irq(unsigned int irq, unsigned int mask);
+        void refresh_all_irqs();
+
+        unsigned int highest_pending_irq(unsigned int cpu,
+                                         unsigned int& prio) const;
+
+        void update_cpu(unsigned int cpu, bool virt);
     };
 
     inline irq_target_socket&
@@ -414,11 +449,15 @@ namespace vcml { namespace arm {
     }
 
     inline void gic400::enable_irq(unsigned int irq, unsigned int mask) {
+        u8 prev = m_irq_state[irq].enabled;
         m_irq_state[irq].enabled |= mask;
+        refresh_irq(irq, prev ^ m_irq_state[irq].enabled);
     }
 
     inline void gic400::disable_irq(unsigned int irq, unsigned int mask) {
+        u8 prev = m_irq_state[irq].enabled;
         m_irq_state[irq].enabled &= ~mask;
+        refresh_irq(irq, prev ^ m_irq_state[irq].enabled);
     }
 
     inline bool gic400::is_irq_enabled(unsigned int irq, unsigned int mask) {
@@ -427,10 +466,12 @@ namespace vcml { namespace arm {
 
     inline void gic400::set_irq_pending(unsigned int irq, bool pending,
                                        unsigned int mask) {
+        u8 prev = m_irq_state[irq].pending;
         if (pending)
             m_irq_state[irq].pending |= mask;
         else
             m_irq_state[irq].pending &= ~mask;
+        refresh_irq(irq, prev ^ m_irq_state[irq].pending);
     }
 
     inline bool gic400::is_irq_pending(unsigned int irq, unsigned int mask) {
@@ -439,10 +480,12 @@ namespace vcml { namespace arm {
 
     inline void gic400::set_irq_active(unsigned int irq, bool active,
                                         unsigned int mask) {
+        u8 prev = m_irq_state[irq].active;
         if (active)
             m_irq_state[irq].active |= mask;
         else
             m_irq_state[irq].active &= ~mask;
+        refresh_irq(irq, prev ^ m_irq_state[irq].active);
     }
 
     inline bool gic400::is_irq_active(unsigned int irq, unsigned int mask) {
@@ -451,10 +494,12 @@ namespace vcml { namespace arm {
 
     inline void gic400::set_irq_level(unsigned int irq, bool level,
                                        unsigned int mask) {
+        u8 prev = m_irq_state[irq].level;
         if (level)
             m_irq_state[irq].level |= mask;
         else
             m_irq_state[irq].level &= ~mask;
+        refresh_irq(irq, prev ^ m_irq_state[irq].level);
     }
 
     inline bool gic400::get_irq_level(unsigned int irq, unsigned int mask) {
@@ -474,15 +519,20 @@ namespace vcml { namespace arm {
     }
 
     inline void gic400::set_irq_trigger(unsigned int irq, trigger_mode t) {
+        if (m_irq_state[irq].trigger == t)
+            return;
         m_irq_state[irq].trigger = t;
+        refresh_irq(irq, ALL_CPU);
     }
 
     inline void gic400::set_irq_signaled(unsigned int irq, bool signaled,
                                          unsigned int mask) {
+        u8 prev = m_irq_state[irq].signaled;
         if (signaled)
             m_irq_state[irq].signaled |= mask;
         else
             m_irq_state[irq].signaled &= ~mask;
+        refresh_irq(irq, prev ^ m_irq_state[irq].signaled);
     }
 
     inline bool gic400::irq_signaled(unsigned int irq, unsigned int mask) {
@@ -44,7 +44,13 @@ namespace vcml { namespace arm {
         u32  m_current_irq;
         bool m_vect_int;
 
+        // sources assigned to an enabled vector slot and the highest
+        // priority (i.e. lowest) slot that each of them is assigned to
+        u32  m_vect_sources;
+        u8   m_source_slot[VCML_ARM_PL190VIC_NIRQ];
+
         void update();
+        void update_slots();
 
         u32 write_INTE(u32 val);
         u32 write_IECR(u32 val);
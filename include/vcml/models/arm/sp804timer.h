@@ -36,7 +36,12 @@ namespace vcml { namespace arm {
     {
     private:
         SC_HAS_PROCESS(sp804timer);
+
+        sc_event m_ev;
+
         void update_IRQC();
+        void trigger();
+        void schedule();
 
         // disabled
         sp804timer();
@@ -49,15 +54,22 @@ namespace vcml { namespace arm {
         class timer: public peripheral
         {
         private:
-            SC_HAS_PROCESS(timer);
+            friend class sp804timer;
 
-            sc_event    m_ev;
-            sc_time     m_prev;
-            sc_time     m_next;
+            sc_time     m_start;    // when counting started from m_count
+            u32         m_count;    // counter value at m_start
+            sc_time     m_deadline; // next expiry to wake up for
+            bool        m_armed;    // whether m_deadline is valid
             sp804timer* m_timer;
 
-            void trigger();
-            void schedule(u32 ticks);
+            u32 wrap_mask() const { return is_32bit() ? ~0u : 0xffffu; }
+            u32 reload_value() const;
+            sc_time tick() const;
+
+            u32 current_value() const;
+            void restart(u32 count, bool inclusive);
+            void rearm(bool inclusive);
+            void expire();
 
             u32 read_VALUE();
             u32 read_RIS();
@@ -22,6 +22,7 @@
 #include "vcml/common/types.h"
 #include "vcml/common/report.h"
 #include "vcml/common/systemc.h"
+#include "vcml/common/bitops.h"
 
 #include "vcml/protocols/tlm.h"
 
@@ -32,19 +33,35 @@ namespace vcml { namespace generic {
 
     class gpio: public peripheral
     {
+    public:
+        enum : size_t {
+            NLINES = 256,
+            NPORTS = NLINES / 32,
+        };
+
     private:
+        out_port<bool>* m_lines[NLINES];
+
+        void update_port(size_t port, u32 val);
+
         bool cmd_status(const vector<string>& args, ostream& os);
         bool cmd_set(const vector<string>& args, ostream& os);
         bool cmd_clear(const vector<string>& args, ostream& os);
 
-        u32 read_DATA();
-        u32 write_DATA(u32 val);
+        u32 write_DATA(u32 val, size_t port);
+        u32 write_SET(u32 val, size_t port);
+        u32 write_CLEAR(u32 val, size_t port);
+        u32 write_TOGGLE(u32 val, size_t port);
 
         // disabled
         gpio();
         gpio(const gpio&);
     public:
-        reg<u32> DATA;
+        // each port covers 32 lines, 64bit accesses span two ports
+        reg<u32, NPORTS> DATA;
+        reg<u32, NPORTS> SET;
+        reg<u32, NPORTS> CLEAR;
+        reg<u32, NPORTS> TOGGLE;
 
         out_port_list<bool> GPIO;
         tlm_target_socket IN;
@@ -54,6 +71,9 @@ namespace vcml { namespace generic {
         VCML_KIND(gpio);
         virtual void reset() override;
 
+        bool read_line(size_t line) const;
+        void write_line(size_t line, bool state);
+
         virtual void end_of_elaboration() override;
     };
 
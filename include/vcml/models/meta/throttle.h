@@ -33,20 +33,45 @@ namespace vcml { namespace meta {
     class throttle : public module
     {
     private:
+        struct sample {
+            u64 sim_ns;
+            u64 real_ns;
+        };
+
         bool m_throttling;
-        u64  m_time_real;
+        double m_rtf;
+        u64 m_spin_ns;
+
+        deque<sample> m_window;
+
+        u64 m_start_ns;
+        u64 m_sleep_ns;
+        u64 m_updates;
+        u64 m_lag_max;
+        u64 m_lag_sum;
 
+        void calibrate();
+        u64 pace(u64 deadline);
         void update();
 
+        bool cmd_stats(const vector<string>& args, ostream& os);
+
     public:
         property<sc_time> update_interval;
         property<double> rtf;
+        property<unsigned int> window;
 
         throttle(const sc_module_name& nm);
         virtual ~throttle();
         VCML_KIND(throttle);
 
         bool is_throttling() const { return m_throttling; }
+
+        u64 max_lag_ns() const { return m_lag_max; }
+        u64 avg_lag_ns() const;
+        double sleep_ratio() const;
+
+        void reset_stats();
     };
 
 }}
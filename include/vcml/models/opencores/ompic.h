@@ -40,6 +40,8 @@ namespace vcml { namespace opencores {
         u32* m_control;
         u32* m_status;
 
+        vector<irq_initiator_socket*> m_irq;
+
         u32 read_STATUS(size_t core_idx);
         u32 read_CONTROL(size_t core_idx);
 
@@ -65,6 +67,12 @@ namespace vcml { namespace opencores {
         virtual ~ompic();
 
         VCML_KIND(ompic);
+
+        void send_ipi(unsigned int self, unsigned int dest, u16 data);
+        void ack_ipi(unsigned int self);
+
+    protected:
+        virtual void end_of_elaboration() override;
     };
 
 }}
@@ -38,14 +38,26 @@ namespace vcml { namespace riscv {
         sc_time m_time_reset;
         sc_event m_trigger;
 
+        // harts waiting for their timer, as a min-heap on MTIMECMP
+        vector<size_t> m_heap;
+        vector<size_t> m_heap_pos;
+
         u64 get_cycles() const;
 
+        u64 heap_key(size_t pos) const;
+        void heap_swap(size_t a, size_t b);
+        void heap_sift_up(size_t pos);
+        void heap_sift_down(size_t pos);
+        void heap_update(size_t hart);
+        void heap_remove(size_t hart);
+
         u32 read_MSIP(size_t hart);
         u32 write_MSIP(u32 val, size_t hart);
         u64 write_MTIMECMP(u64 val, size_t hart);
         u64 read_MTIME();
 
         void update_timer();
+        void schedule_timer(u64 mtime);
 
         // disabled
         clint();
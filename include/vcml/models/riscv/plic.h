@@ -39,10 +39,19 @@ namespace vcml { namespace riscv {
         static const int NCTX = 15872;
 
     private:
+        static const int NWORDS = NIRQ / 64;
+
         struct context {
             static const u64 BASE = 0x200000;
             static const u64 SIZE = 0x001000;
 
+            const size_t id;
+
+            u64 enabled[NWORDS];
+            u64 pending[NWORDS]; // pending, enabled and unclaimed
+            u32 best;            // claim candidate, valid unless dirty
+            bool dirty;
+
             reg<u32>* ENABLED[NIRQ / 32];
             reg<u32> THRESHOLD;
             reg<u32> CLAIM;
@@ -52,11 +61,12 @@ namespace vcml { namespace riscv {
         };
 
         u32 m_claims[NIRQ];
+        u64 m_pending[NWORDS]; // pending and unclaimed
         context* m_contexts[NCTX];
+        vector<context*> m_active;
 
         bool is_pending(size_t irqno) const;
         bool is_claimed(size_t irqno) const;
-        bool is_enabled(size_t irqno, size_t ctxno) const;
 
         u32 irq_priority(size_t irqno) const;
         u32 ctx_threshold(size_t ctxno) const;
@@ -69,7 +79,14 @@ namespace vcml { namespace riscv {
         u32 write_THRESHOLD(u32 value, size_t ctxno);
         u32 write_COMPLETE(u32 value, size_t ctxno);
 
-        void update();
+        bool is_better(size_t irqno, u32 than) const;
+
+        void offer(context* ctx, size_t irqno);
+        void withdraw(context* ctx, size_t irqno);
+        void set_available(size_t irqno, bool available);
+
+        u32 best_candidate(context* ctx);
+        void update(context* ctx);
 
         // disabled
         plic();
@@ -25,6 +25,7 @@
 #include "vcml/common/systemc.h"
 
 #include "vcml/logging/logger.h"
+#include "vcml/logging/trace_bin.h"
 #include "vcml/properties/property.h"
 
 #include "vcml/command.h"
@@ -36,16 +37,41 @@ namespace vcml {
     private:
         std::map<string, command_base*> m_commands;
 
+        vector<string> m_trace_globs;
+        bool m_trace_all;
+        unordered_map<const void*, bool> m_trace_ports;
+
         bool cmd_clist(const vector<string>& args, ostream& os);
         bool cmd_cinfo(const vector<string>& args, ostream& os);
         bool cmd_abort(const vector<string>& args, ostream& os);
 
         log_level default_log_level() const;
+        module* parent_module() const;
+        bool lookup_traced(const void* port, const char* name);
+
+        template <typename T>
+        T inherit(property<T> module::*prop, const T& def) const;
+
+        template <typename PAYLOAD>
+        bool trace_accept(const PAYLOAD& tx) const;
+        bool trace_accept(const tlm_generic_payload& tx) const;
 
     public:
         property<bool> trace_errors;
         property<log_level> loglvl;
 
+        // trace_sockets is only evaluated during construction, since
+        // sockets cache whether they are traced. The address and command
+        // filters below are checked on every traced transaction and may
+        // be changed at any time.
+        property<string> trace_sockets;
+        property<u64> trace_start;
+        property<u64> trace_end;
+        property<bool> trace_reads;
+        property<bool> trace_writes;
+        property<bool> trace_debug;
+        property<bool> trace_insn;
+
         module() = delete;
         module(const module&) = delete;
         module(const sc_module_name& nm);
@@ -69,19 +95,38 @@ namespace vcml {
         command_base* get_command(const string& name);
         vector<command_base*> get_commands() const;
 
+        template <typename PORT>
+        bool is_traced(const PORT& port);
+
+        bool would_log(log_level lvl) const {
+            return lvl <= loglvl && logger::would_log(lvl);
+        }
+
 #ifndef VCML_OMIT_LOGGING_SOURCE
+        void log_publish(log_level lvl, const char* file, int line,
+                         const char* format, ...) const VCML_DECL_PRINTF(5, 6);
+
+#ifdef VCML_HAVE_VA_ARG_PACK
+        VCML_DECL_ALWAYS_INLINE
+        void log_tagged(log_level lvl, const char* file, int line,
+                        const char* format, ...) const VCML_DECL_PRINTF(5, 6) {
+            if (would_log(lvl))
+                log_publish(lvl, file, line, format, __builtin_va_arg_pack());
+        }
+#else
         void log_tagged(log_level lvl, const char* file, int line,
                         const char* format, ...) const VCML_DECL_PRINTF(5, 6) {
-            if (lvl <= loglvl && logger::would_log(lvl)) {
+            if (would_log(lvl)) {
                 va_list args; va_start(args, format);
                 logger::publish(lvl, name(), vmkstr(format, args), file, line);
                 va_end(args);
             }
         }
+#endif
 #else
 #define VCML_GEN_LOGFN(func, lvl)                                             \
         void func(const char* format, ...) const VCML_DECL_PRINTF(2, 3) {     \
-            if (lvl <= loglvl && logger::would_log(lvl)) {                    \
+            if (would_log(lvl)) {                                             \
                 va_list args; va_start(args, format);                         \
                 logger::publish(lvl, name(), vmkstr(format, args));           \
                 va_end(args);                                                 \
@@ -133,10 +178,34 @@ namespace vcml {
         return m_commands[name];
     }
 
+    template <typename T>
+    inline T module::inherit(property<T> module::*prop, const T& def) const {
+        module* parent = parent_module();
+        return parent ? (parent->*prop).get() : def;
+    }
+
+    template <typename PAYLOAD>
+    inline bool module::trace_accept(const PAYLOAD& tx) const {
+        return true; // only TLM transactions can be filtered further
+    }
+
+    template <typename PORT>
+    inline bool module::is_traced(const PORT& port) {
+        return m_trace_all || lookup_traced(&port, port.name());
+    }
+
     template <typename PORT, typename PAYLOAD>
     inline void module::trace(trace_direction dir, const PORT& port,
                               const PAYLOAD& tx, const sc_time& dt) {
-        if (loglvl < LOG_TRACE || !logger::would_log(LOG_TRACE))
+        if (loglvl < LOG_TRACE)
+            return;
+
+        bool text = logger::would_log(LOG_TRACE);
+        bool binary = trace_bin::active() != nullptr;
+        if (!text && !binary)
+            return;
+
+        if (!is_traced(port) || !trace_accept(tx))
             return;
 
         if (trace_errors) {
@@ -146,7 +215,10 @@ namespace vcml {
             dir = (dir != TRACE_BW) ? dir : TRACE_BW_NOINDENT;
         }
 
-        logger::trace(dir, port, tx, dt);
+        if (binary)
+            trace_bin::trace(dir, port, tx, dt);
+        if (text)
+            logger::trace(dir, port, tx, dt);
     }
 
     template <typename PORT, typename PAYLOAD>
@@ -38,6 +38,11 @@
 
 namespace vcml {
 
+    // Histogram bucket i counts times in [2^i, 2^(i+1)) nanoseconds, the
+    // first bucket also holds everything below 1ns and the last bucket
+    // everything beyond.
+    enum : size_t { IRQ_STATS_BUCKETS = 40 };
+
     struct irq_stats {
         unsigned int irq;
         unsigned int irq_count;
@@ -45,8 +50,23 @@ namespace vcml {
         sc_time      irq_last;
         sc_time      irq_uptime;
         sc_time      irq_longest;
+        u64          irq_duration[IRQ_STATS_BUCKETS]; // assertion times
+        u64          irq_interval[IRQ_STATS_BUCKETS]; // inter-arrival times
+        vector<u64>  irq_rate; // ring of assertions per irq_stats_window
+        u64          irq_rate_last; // number of the newest window in ring
+
+        // returns the number of assertions in the given window, which is
+        // only known for the last irq_stats_windows windows
+        u64 rate(u64 window) const;
     };
 
+    inline u64 irq_stats::rate(u64 window) const {
+        if (irq_rate.empty() || window > irq_rate_last ||
+            window + irq_rate.size() <= irq_rate_last)
+            return 0;
+        return irq_rate[window % irq_rate.size()];
+    }
+
     class processor: public component,
                      public irq_target,
                      protected debugging::target {
@@ -56,7 +76,9 @@ namespace vcml {
 
         debugging::gdbserver* m_gdb;
 
-        unordered_map<unsigned int, irq_stats> m_irq_stats;
+        u64 m_irq_window;
+        size_t m_irq_windows;
+        vector<irq_stats> m_irq_stats;
         unordered_map<u64, property_base*> m_regprops;
 
         bool cmd_dump(const vector<string>& args, ostream& os);
@@ -80,6 +102,12 @@ namespace vcml {
         property<bool> gdb_wait;
         property<bool> gdb_echo;
 
+        // irq rates are recorded per irq_stats_window, keeping only the
+        // last irq_stats_windows windows to bound memory usage
+        property<sc_time> irq_stats_window;
+        property<unsigned int> irq_stats_windows;
+        property<string> irq_stats_file;
+
         irq_target_socket_array<> IRQ;
 
         tlm_initiator_socket INSN;
@@ -103,6 +131,7 @@ namespace vcml {
         virtual void reset() override;
 
         bool get_irq_stats(unsigned int irq, irq_stats& stats) const;
+        void write_irq_stats(ostream& os) const;
 
         template <typename T>
         inline tlm_response_status fetch (u64 addr, T& data);
@@ -126,6 +155,7 @@ namespace vcml {
         virtual void simulate(unsigned int cycles) = 0;
         virtual void update_local_time(sc_time& local_time) override;
         virtual void end_of_elaboration() override;
+        virtual void end_of_simulation() override;
 
         virtual void fetch_cpuregs();
         virtual void flush_cpuregs();
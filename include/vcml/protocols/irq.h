@@ -32,6 +32,7 @@ namespace vcml {
 
     enum irq_vectors : irq_vector {
         IRQ_NO_VECTOR = SIZE_MAX,
+        IRQ_DENSE_VECTORS = 64, // vectors below this are kept in a bitmask
     };
 
     struct irq_payload {
@@ -169,14 +170,30 @@ namespace vcml {
         void raise_irq(irq_vector vector = IRQ_NO_VECTOR);
         void lower_irq(irq_vector vector = IRQ_NO_VECTOR);
 
+        u64 read_vectors() const { return m_dense; }
+        void write_vectors(u64 mask, u64 values);
+
+        // Records the desired state only. Deferred writes are applied at
+        // the end of the outermost transaction (see irq_defer_guard) or
+        // in the next delta cycle, whichever comes first.
+        void write_deferred(bool state, irq_vector vector = IRQ_NO_VECTOR);
+        void flush_deferred();
+        bool has_deferred() const { return !m_deferred.empty(); }
+
         irq_initiator_socket& operator = (bool set);
         irq_state_tracker& operator [] (irq_vector vector);
 
     private:
         module* m_parent;
         irq_target* m_host;
+        irq_state_tracker m_default;
+        vector<irq_state_tracker> m_vectors;
+        u64 m_dense;
         unordered_map<irq_vector, irq_state_tracker> m_state;
         sc_event* m_event;
+        vector<irq_payload> m_deferred;
+        vector<irq_initiator_socket*>* m_defer_list;
+        sc_event* m_flush_ev;
 
         struct irq_bw_transport : public irq_bw_transport_if {
             irq_initiator_socket* socket;
@@ -200,9 +217,13 @@ namespace vcml {
         bool read(irq_vector vector = IRQ_NO_VECTOR) const;
         operator bool () const { return read(IRQ_NO_VECTOR); }
 
+        u64 read_vectors() const { return m_dense; }
+
     private:
         module* m_parent;
         irq_target* m_host;
+        bool m_default;
+        u64 m_dense;
         unordered_map<irq_vector, bool> m_state;
         sc_event* m_event;
 
@@ -220,6 +241,25 @@ namespace vcml {
         void irq_transport(irq_payload& irq);
     };
 
+    struct irq_defer_state;
+
+    // Delays flushing deferred irq writes until the outermost guard of the
+    // current process is destroyed, so that they get coalesced across a
+    // whole transaction. Other processes blocked inside their own guards
+    // do not delay the flush.
+    class irq_defer_guard
+    {
+    private:
+        irq_defer_state* m_state;
+
+    public:
+        irq_defer_guard();
+        ~irq_defer_guard();
+
+        // flushes writes deferred by the current process
+        static void flush();
+    };
+
     template <const size_t MAX = SIZE_MAX>
     using irq_initiator_socket_array = socket_array<irq_initiator_socket, MAX>;
 
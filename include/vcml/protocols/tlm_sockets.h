@@ -47,6 +47,7 @@ namespace vcml {
         tlm_host*           m_host;
         module*             m_parent;
         module*             m_adapter;
+        bool                m_traced;
 
         void invalidate_direct_mem_ptr(sc_dt::uint64 start, sc_dt::uint64 end);
 
@@ -216,6 +217,7 @@ namespace vcml {
         tlm_host*           m_host;
         module*             m_parent;
         module*             m_adapter;
+        bool                m_traced;
 
         void b_transport(tlm_generic_payload& tx, sc_time& dt);
         unsigned int transport_dbg(tlm_generic_payload& tx);
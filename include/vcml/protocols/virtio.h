@@ -287,19 +287,35 @@ namespace vcml {
         bool get(vq_message& msg);
         bool put(vq_message& msg);
 
+        bool would_log(log_level lvl) const {
+            return parent->would_log(lvl);
+        }
+
 #ifndef VCML_OMIT_LOGGING_SOURCE
+        void log_publish(log_level lvl, const char* file, int line,
+                         const char* format, ...) const VCML_DECL_PRINTF(5, 6);
+
+#ifdef VCML_HAVE_VA_ARG_PACK
+        VCML_DECL_ALWAYS_INLINE
+        void log_tagged(log_level lvl, const char* file, int line,
+                        const char* format, ...) const VCML_DECL_PRINTF(5, 6) {
+            if (would_log(lvl))
+                log_publish(lvl, file, line, format, __builtin_va_arg_pack());
+        }
+#else
         void log_tagged(log_level lvl, const char* file, int line,
                         const char* format, ...) const VCML_DECL_PRINTF(5, 6) {
-            if (lvl <= parent->loglvl && logger::would_log(lvl)) {
+            if (would_log(lvl)) {
                 va_list args; va_start(args, format);
                 logger::publish(lvl, name(), vmkstr(format, args), file, line);
                 va_end(args);
             }
         }
+#endif
 #else
 #define VCML_GEN_LOGFN(func, lvl)                                             \
         void func(const char* format, ...) const VCML_DECL_PRINTF(2, 3) {     \
-            if (lvl <= loglvl && logger::would_log(lvl)) {                    \
+            if (would_log(lvl)) {                                             \
                 va_list args; va_start(args, format);                         \
                 logger::publish(lvl, name(), vmkstr(format, args));           \
                 va_end(args);                                                 \
@@ -27,6 +27,8 @@
 #include "vcml/logging/log_term.h"
 #include "vcml/logging/log_file.h"
 #include "vcml/logging/log_stream.h"
+#include "vcml/logging/log_async.h"
+#include "vcml/logging/trace_bin.h"
 
 #include "vcml/properties/property.h"
 #include "vcml/properties/broker.h"
@@ -42,13 +44,16 @@ namespace vcml {
         bool m_log_debug;
         bool m_log_stdout;
         bool m_trace_stdout;
+        bool m_log_async;
 
         vector<string>  m_args;
         vector<string>  m_log_files;
         vector<string>  m_trace_files;
         vector<string>  m_config_files;
+        string          m_trace_bin_file;
 
         vector<logger*> m_loggers;
+        trace_bin*      m_trace_bin;
         vector<broker*> m_brokers;
 
         bool parse_command_line(int argc, char** argv);
@@ -63,10 +68,12 @@ namespace vcml {
         bool is_logging_debug() const { return m_log_debug; }
         bool is_logging_stdout() const { return m_log_stdout; }
         bool trace_stdout() const { return m_trace_stdout; }
+        bool is_logging_async() const { return m_log_async; }
 
         const vector<string>& log_files() const { return m_log_files; }
         const vector<string>& trace_files() const { return m_trace_files; }
         const vector<string>& config_files() const { return m_config_files; }
+        const string& trace_bin_file() const { return m_trace_bin_file; }
 
         unsigned int argc() const { return m_args.size(); }
         const vector<string>& argv() const { return m_args; }
@@ -22,6 +22,7 @@
 #include "vcml/common/types.h"
 #include "vcml/common/report.h"
 #include "vcml/debugging/vspserver.h"
+#include "vcml/debugging/gdbserver.h"
 #include "vcml/module.h"
 
 namespace vcml {
@@ -29,6 +30,8 @@ namespace vcml {
     class system: public module
     {
     private:
+        debugging::gdbserver* m_gdb;
+
         void timeout();
 
     public:
@@ -44,6 +47,10 @@ namespace vcml {
         property<sc_time> quantum;
         property<sc_time> duration;
 
+        property<int>     gdb_port;
+        property<bool>    gdb_wait;
+        property<bool>    gdb_echo;
+
         system() = delete;
         system(const system&) = delete;
         explicit system(const sc_module_name& name);
@@ -51,6 +58,9 @@ namespace vcml {
         VCML_KIND(system);
 
         virtual int run();
+
+    protected:
+        virtual void end_of_elaboration() override;
     };
 
 }
@@ -42,6 +42,8 @@ namespace vcml { namespace ui {
         u8*    m_fb;
         u8*    m_nullfb;
 
+        thctl_resource m_fbres;
+
         vector<keyboard*> m_keyboards;
         vector<pointer*> m_pointers;
 
@@ -70,6 +72,9 @@ namespace vcml { namespace ui {
         u64  framebuffer_size() const { return m_mode.size; }
         bool has_framebuffer()  const { return m_mode.size > 0; }
 
+        // hold a thctl_shared_guard on this while scanning out the pixels
+        thctl_resource& framebuffer_resource() { return m_fbres; }
+
         virtual ~display();
 
         virtual void init(const fbmode& mode, u8* fbptr);
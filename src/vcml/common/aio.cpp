@@ -18,7 +18,10 @@
 
 #include "vcml/common/aio.h"
 
-#include <poll.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
 
 namespace vcml {
 
@@ -27,76 +30,160 @@ namespace vcml {
     {
     private:
         mutable mutex m_mtx;
-        unordered_map<int, aio_handler> m_handlers;
-        atomic<u64> m_gen;
+        condition_variable m_done;
+        unordered_map<int, shared_ptr<aio_handler>> m_handlers;
+        vector<int> m_always_ready;
+
+        int m_epoll;
+        int m_wakeup;
+        int m_active;
 
         atomic<bool> m_running;
         thread m_thread;
 
-        static const int timeout_ms = 10;
+        enum : int {
+            MAX_EVENTS = 64,
+            TIMEOUT_MS = 10, // poll interval for fds that epoll rejects
+        };
 
-        void aio_thread() {
-            vector<struct pollfd> polls;
-            u64 curgen = 0;
+        void wakeup() {
+            u64 one = 1;
+            if (::write(m_wakeup, &one, sizeof(one)) != sizeof(one))
+                VCML_ERROR("aio wakeup failed: %s", strerror(errno));
+        }
 
-            while (m_running) {
-                if (curgen != m_gen) {
-                    polls.clear();
+        void dispatch(int fd) {
+            std::unique_lock<mutex> lock(m_mtx);
+            auto it = m_handlers.find(fd);
+            if (it == m_handlers.end())
+                return; // fd has been removed
 
-                    lock_guard<mutex> guard(m_mtx);
-                    for (auto it : m_handlers)
-                        polls.push_back({it.first, POLLIN | POLLPRI, 0});
+            shared_ptr<aio_handler> handler = it->second;
+            m_active = fd;
+            lock.unlock();
 
-                    curgen = m_gen;
-                }
+            (*handler)(fd);
 
-                if (polls.empty()) {
-                    auto timeout = std::chrono::milliseconds(timeout_ms);
-                    std::this_thread::sleep_for(timeout);
-                    continue;
-                }
+            lock.lock();
+            m_active = -1;
+            m_done.notify_all();
+        }
 
-                int ret = poll(polls.data(), polls.size(), timeout_ms);
-                VCML_ERROR_ON(ret < 0, "aio error: %s", strerror(errno));
+        void aio_thread() {
+            struct epoll_event events[MAX_EVENTS];
+            vector<int> always;
 
-                if (ret > 0 && m_running) {
+            while (m_running) {
+                {
                     lock_guard<mutex> guard(m_mtx);
-                    for (const auto& pfd : polls) {
-                        if (m_handlers.count(pfd.fd) == 0)
-                            continue; // fd has been removed
+                    always = m_always_ready;
+                }
 
-                        if (pfd.revents & POLLNVAL)
-                            VCML_ERROR("invalid file descriptor: %d", pfd.fd);
+                int timeout = always.empty() ? -1 : (int)TIMEOUT_MS;
+                int n = epoll_wait(m_epoll, events, MAX_EVENTS, timeout);
+                if (n < 0 && errno == EINTR)
+                    continue;
+
+                VCML_ERROR_ON(n < 0, "aio error: %s", strerror(errno));
 
-                        if (pfd.revents & (POLLIN | POLLPRI))
-                            m_handlers[pfd.fd](pfd.fd);
+                for (int i = 0; i < n && m_running; i++) {
+                    int fd = events[i].data.fd;
+                    if (fd == m_wakeup) {
+                        u64 count;
+                        if (::read(m_wakeup, &count, sizeof(count)) < 0)
+                            VCML_ERROR("aio error: %s", strerror(errno));
+                        continue;
                     }
+
+                    if (events[i].events & (EPOLLIN | EPOLLPRI))
+                        dispatch(fd);
                 }
+
+                for (int fd : always)
+                    if (m_running)
+                        dispatch(fd);
             }
         }
 
     public:
-        aio(): m_mtx(), m_handlers(), m_gen(), m_running(true), m_thread() {
+        aio():
+            m_mtx(),
+            m_done(),
+            m_handlers(),
+            m_always_ready(),
+            m_epoll(epoll_create1(EPOLL_CLOEXEC)),
+            m_wakeup(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)),
+            m_active(-1),
+            m_running(true),
+            m_thread() {
+            VCML_ERROR_ON(m_epoll < 0, "epoll: %s", strerror(errno));
+            VCML_ERROR_ON(m_wakeup < 0, "eventfd: %s", strerror(errno));
+
+            struct epoll_event ev = {};
+            ev.events = EPOLLIN;
+            ev.data.fd = m_wakeup;
+            if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wakeup, &ev) < 0)
+                VCML_ERROR("epoll_ctl: %s", strerror(errno));
+
             m_thread = thread(std::bind(&aio::aio_thread, this));
             set_thread_name(m_thread, "aio_thread");
         }
 
         virtual ~aio() {
             m_running = false;
+            wakeup();
             if (m_thread.joinable())
                 m_thread.join();
+
+            close(m_wakeup);
+            close(m_epoll);
         }
 
-        void notify(int fd, aio_handler handler) {
+        void notify(int fd, aio_handler handler, aio_policy policy) {
             lock_guard<mutex> guard(m_mtx);
-            m_handlers[fd] = handler;
-            m_gen++;
+
+            struct epoll_event ev = {};
+            ev.events = EPOLLIN | EPOLLPRI;
+            if (policy == AIO_EDGE)
+                ev.events |= EPOLLET;
+            ev.data.fd = fd;
+
+            int op = stl_contains(m_handlers, fd) ? EPOLL_CTL_MOD
+                                                  : EPOLL_CTL_ADD;
+
+            m_handlers[fd] = std::make_shared<aio_handler>(std::move(handler));
+            if (stl_contains(m_always_ready, fd))
+                return;
+
+            if (epoll_ctl(m_epoll, op, fd, &ev) == 0)
+                return;
+
+            // regular files and some character devices cannot be used with
+            // epoll; they are always readable, so just poll them regularly
+            if (errno == EPERM) {
+                stl_add_unique(m_always_ready, fd);
+                wakeup();
+                return;
+            }
+
+            m_handlers.erase(fd);
+            VCML_ERROR("aio cannot watch fd %d: %s", fd, strerror(errno));
         }
 
         void cancel(int fd) {
-            lock_guard<mutex> guard(m_mtx);
-            m_handlers.erase(fd);
-            m_gen++;
+            std::unique_lock<mutex> lock(m_mtx);
+            if (m_handlers.erase(fd) == 0)
+                return;
+
+            stl_remove_erase(m_always_ready, fd);
+            epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, nullptr); // may be closed
+
+            // wait for a running handler to finish, unless we are called
+            // from within that handler
+            if (std::this_thread::get_id() == m_thread.get_id())
+                return;
+
+            m_done.wait(lock, [&]() -> bool { return m_active != fd; });
         }
 
         static aio& instance() {
@@ -106,10 +193,10 @@ namespace vcml {
     };
 
 #endif // __linux__
-    
-    void aio_notify(int fd, aio_handler handler) {
+
+    void aio_notify(int fd, aio_handler handler, aio_policy policy) {
 #ifdef __linux__
-        aio::instance().notify(fd, handler);
+        aio::instance().notify(fd, std::move(handler), policy);
 #endif
     }
 
@@ -120,4 +207,3 @@ namespace vcml {
     }
 
 }
-
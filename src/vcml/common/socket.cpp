@@ -130,7 +130,10 @@ namespace vcml {
         m_ipv6(),
         m_socket(-1),
         m_conn(-1),
-        m_async() {
+        m_async(),
+        m_rxbuf(RXBUF_SIZE),
+        m_rxpos(0),
+        m_rxlen(0) {
     }
 
     socket::socket(u16 port):
@@ -140,7 +143,10 @@ namespace vcml {
         m_ipv6(),
         m_socket(-1),
         m_conn(-1),
-        m_async() {
+        m_async(),
+        m_rxbuf(RXBUF_SIZE),
+        m_rxpos(0),
+        m_rxlen(0) {
         listen(port);
     }
 
@@ -151,7 +157,10 @@ namespace vcml {
         m_ipv6(),
         m_socket(-1),
         m_conn(-1),
-        m_async() {
+        m_async(),
+        m_rxbuf(RXBUF_SIZE),
+        m_rxpos(0),
+        m_rxlen(0) {
         connect(host, port);
     }
 
@@ -293,12 +302,16 @@ namespace vcml {
         ::shutdown(fd, SHUT_RDWR);
 
         m_peer.clear();
+        m_rxpos = m_rxlen = 0;
     }
 
     size_t socket::peek(time_t timeoutms) {
         if (!is_connected())
             return 0;
 
+        if (buffered() > 0)
+            return buffered();
+
         if (m_async.joinable())
             m_async.join();
 
@@ -340,26 +353,46 @@ namespace vcml {
         }
     }
 
+    size_t socket::fill(void* data, size_t size) {
+        int r = ::recv(m_conn, data, size, 0);
+        if (r <= 0)
+            disconnect();
+        if (r == 0)
+            VCML_REPORT("error receiving data: disconnected");
+        if (r < 0)
+            VCML_REPORT("error receiving data: %s", strerror(errno));
+        return r;
+    }
+
     void socket::recv(void* data, size_t size) {
+        u8* ptr = (u8*)data;
+        size_t n = min(size, buffered());
+
+        memcpy(ptr, m_rxbuf.data() + m_rxpos, n);
+        m_rxpos += n;
+
+        if (n == size)
+            return;
+
         if (m_async.joinable())
             m_async.join();
 
         if (!is_connected())
             VCML_REPORT("error receiving data: not connected");
 
-        u8* ptr = (u8*)data;
-        size_t n = 0;
+        // large reads bypass the buffer, small reads refill it with as much
+        // data as the kernel has available to save on recv syscalls
+        while (size - n >= m_rxbuf.size())
+            n += fill(ptr + n, size - n);
 
         while (n < size) {
-            int r = ::recv(m_conn, ptr + n, size - n, 0);
-            if (r <= 0)
-                disconnect();
-            if (r == 0)
-                VCML_REPORT("error receiving data: disconnected");
-            if (r < 0)
-                VCML_REPORT("error receiving data: %s", strerror(errno));
+            m_rxpos = 0;
+            m_rxlen = fill(m_rxbuf.data(), m_rxbuf.size());
 
-            n += r;
+            size_t k = min(size - n, m_rxlen);
+            memcpy(ptr + n, m_rxbuf.data(), k);
+            m_rxpos = k;
+            n += k;
         }
     }
 
@@ -162,6 +162,165 @@ namespace vcml {
 #endif
     }
 
+    // Hierarchical timing wheel keyed by the raw kernel time value. Level l
+    // holds timers whose deadline first differs from the current wheel time
+    // in byte l, indexed by that byte. Timers are linked into their slot
+    // directly, so arming and cancelling never allocate and take O(1).
+    class timer_wheel
+    {
+    private:
+        enum : size_t {
+            LEVEL_BITS = 8,
+            NUM_SLOTS = 1 << LEVEL_BITS,
+            NUM_LEVELS = 64 / LEVEL_BITS,
+            NUM_WORDS = NUM_SLOTS / 64,
+            EXPIRED = NUM_LEVELS * NUM_SLOTS,
+        };
+
+        u64 m_now;
+        size_t m_count;
+        timer* m_slots[EXPIRED + 1];
+        u64 m_used[NUM_LEVELS][NUM_WORDS];
+
+        void link(timer* t, size_t slot) {
+            t->m_slot = slot;
+            t->m_prev = nullptr;
+            t->m_next = m_slots[slot];
+            if (t->m_next)
+                t->m_next->m_prev = t;
+            m_slots[slot] = t;
+
+            if (slot != EXPIRED) {
+                size_t idx = slot % NUM_SLOTS;
+                m_used[slot / NUM_SLOTS][idx / 64] |= 1ull << (idx % 64);
+            }
+        }
+
+        void unlink(timer* t) {
+            const size_t slot = t->m_slot;
+            if (t->m_next)
+                t->m_next->m_prev = t->m_prev;
+            if (t->m_prev)
+                t->m_prev->m_next = t->m_next;
+            else
+                m_slots[slot] = t->m_next;
+
+            t->m_slot = timer::NO_SLOT;
+            t->m_prev = t->m_next = nullptr;
+
+            if (slot != EXPIRED && m_slots[slot] == nullptr) {
+                size_t idx = slot % NUM_SLOTS;
+                m_used[slot / NUM_SLOTS][idx / 64] &= ~(1ull << (idx % 64));
+            }
+        }
+
+        timer* detach(size_t slot) {
+            timer* head = m_slots[slot];
+            size_t idx = slot % NUM_SLOTS;
+            m_used[slot / NUM_SLOTS][idx / 64] &= ~(1ull << (idx % 64));
+            m_slots[slot] = nullptr;
+            return head;
+        }
+
+        bool level_used(size_t level) const {
+            for (size_t w = 0; w < NUM_WORDS; w++)
+                if (m_used[level][w])
+                    return true;
+            return false;
+        }
+
+        void place(timer* t) {
+            const u64 deadline = t->m_timeout.value();
+            const u64 diff = deadline ^ m_now;
+            const size_t level = diff ? fls(diff) / LEVEL_BITS : 0;
+            const size_t idx = (deadline >> (level * LEVEL_BITS)) % NUM_SLOTS;
+            link(t, level * NUM_SLOTS + idx);
+        }
+
+    public:
+        size_t count() const { return m_count; }
+
+        timer_wheel(): m_now(0), m_count(0), m_slots(), m_used() {}
+
+        void insert(timer* t) {
+            VCML_ERROR_ON(t->m_timeout.value() < m_now, "timer in the past");
+            place(t);
+            m_count++;
+        }
+
+        void remove(timer* t) {
+            unlink(t);
+            m_count--;
+        }
+
+        // Moves the wheel forward to 'now' and queues all timers that are due
+        // for pop_expired. Timers from coarser levels whose slot has been
+        // reached but that are not yet due cascade into finer levels.
+        void advance(u64 now) {
+            const u64 prev = m_now;
+            m_now = now;
+
+            for (size_t level = NUM_LEVELS; level-- > 0; ) {
+                if (!level_used(level))
+                    continue;
+
+                const size_t shift = level * LEVEL_BITS;
+                const u64 first = (prev >> shift) + (level ? 1 : 0);
+                const u64 last = now >> shift;
+                if (last < first)
+                    continue;
+
+                const u64 n = min<u64>(last - first + 1, NUM_SLOTS);
+                for (u64 i = 0; i < n; i++) {
+                    const size_t slot = level * NUM_SLOTS +
+                                        (first + i) % NUM_SLOTS;
+                    timer* next = detach(slot);
+                    while (timer* t = next) {
+                        next = t->m_next;
+                        const u64 deadline = t->m_timeout.value();
+                        if (deadline < now)
+                            VCML_ERROR("missed timer event");
+                        if (deadline == now)
+                            link(t, EXPIRED);
+                        else
+                            place(t);
+                    }
+                }
+            }
+        }
+
+        timer* pop_expired() {
+            timer* t = m_slots[EXPIRED];
+            if (t != nullptr)
+                remove(t);
+            return t;
+        }
+
+        // Returns the earliest pending deadline: all timers on a finer level
+        // expire before those on coarser levels and slots are ordered within
+        // a level, so only the first occupied slot needs to be scanned.
+        u64 next() const {
+            if (m_slots[EXPIRED])
+                return m_now;
+
+            for (size_t level = 0; level < NUM_LEVELS; level++) {
+                for (size_t w = 0; w < NUM_WORDS; w++) {
+                    if (!m_used[level][w])
+                        continue;
+
+                    size_t slot = level * NUM_SLOTS + w * 64 +
+                                  ctz(m_used[level][w]);
+                    u64 earliest = ~0ull;
+                    for (timer* t = m_slots[slot]; t; t = t->m_next)
+                        earliest = min<u64>(earliest, t->m_timeout.value());
+                    return earliest;
+                }
+            }
+
+            return ~0ull;
+        }
+    };
+
     // we just need this class to have something that is called every cycle...
     class helper_module: public sc_core::sc_trace_file, private sc_module
     {
@@ -221,62 +380,68 @@ namespace vcml {
 
         vector<function<void(void)>> end_of_elab;
         vector<function<void(void)>> start_of_sim;
+        vector<function<void(void)>> end_of_sim;
+
+        struct cycle_callback {
+            function<void(void)> func;
+            const atomic<bool>* pending;
+        };
+
+        vector<cycle_callback> deltas;
+        vector<cycle_callback> tsteps;
 
-        vector<function<void(void)>> deltas;
-        vector<function<void(void)>> tsteps;
+        u64 num_deltas;
+        u64 num_tsteps;
 
-        struct timer_compare {
-            inline bool
-            operator() (const timer::event* a, const timer::event* b) const {
-                return a->timeout > b->timeout;
+        static void dispatch(const vector<cycle_callback>& callbacks) {
+            for (const cycle_callback& cb : callbacks) {
+                if (cb.pending && !cb.pending->load(std::memory_order_acquire))
+                    continue;
+                cb.func();
             }
-        };
+        }
 
         sc_event timeout_event;
-        std::priority_queue<timer::event*, vector<timer::event*>,
-                            timer_compare> timers;
+        u64 scheduled;
+        timer_wheel timers;
 
-        void update_timer() {
-            if (timers.empty()) {
-                timeout_event.cancel();
+        void schedule(u64 deadline) {
+            if (deadline >= scheduled)
                 return;
-            }
 
-            sc_time next_timeout = timers.top()->timeout;
-            timeout_event.notify(next_timeout - sc_time_stamp());
+            scheduled = deadline;
+            timeout_event.notify(time_from_value(deadline) - sc_time_stamp());
         }
 
         void run_timer() {
-            const sc_time now = sc_time_stamp();
-            while (!timers.empty()) {
-                timer::event* event = timers.top();
-                if (event->timeout > now)
-                    break;
-
-                if (event->timeout < now)
-                    VCML_ERROR("missed timer event");
+            scheduled = ~0ull;
+            timers.advance(sc_time_stamp().value());
+            while (timer* t = timers.pop_expired())
+                t->trigger();
 
-                timers.pop();
-                if (event->owner)
-                    event->owner->trigger();
-                delete event;
-            }
+            if (timers.count() > 0)
+                schedule(timers.next());
+        }
 
-            update_timer();
+        void add_timer(timer* t) {
+            thctl_guard guard;
+            timers.insert(t);
+            schedule(t->timeout().value());
         }
 
-        void add_timer(timer::event* ev) {
+        void remove_timer(timer* t) {
             thctl_guard guard;
-            timers.push(ev);
-            update_timer();
+            if (t->is_pending())
+                timers.remove(t);
         }
 
         helper_module(const sc_module_name& nm):
             sc_core::sc_trace_file(),
             sc_core::sc_module(nm),
             use_phase_callbacks(kernel_has_phase_callbacks()),
-            end_of_elab(), start_of_sim(), deltas(), tsteps(),
-            timeout_event("timeout_ev"), timers() {
+            end_of_elab(), start_of_sim(), end_of_sim(), deltas(), tsteps(),
+            num_deltas(0), num_tsteps(0),
+            timeout_event("timeout_ev"), scheduled(~0ull), timers() {
 #if SYSTEMC_VERSION >= SYSTEMC_VERSION_2_3_1a
             if (use_phase_callbacks) {
                 register_simulation_phase_callback(
@@ -323,11 +488,11 @@ namespace vcml {
     protected:
         virtual void cycle(bool delta_cycle) override {
             if (delta_cycle) {
-                for (auto& func : deltas)
-                    func();
+                num_deltas++;
+                dispatch(deltas);
             } else {
-                for (auto& func : tsteps)
-                    func();
+                num_tsteps++;
+                dispatch(tsteps);
             }
         }
 
@@ -340,6 +505,11 @@ namespace vcml {
             for (auto& func : start_of_sim)
                 func();
         }
+
+        virtual void end_of_simulation() override {
+            for (auto& func : end_of_sim)
+                func();
+        }
     };
 
     void on_end_of_elaboration(function<void(void)> callback) {
@@ -352,18 +522,44 @@ namespace vcml {
         helper.start_of_sim.push_back(callback);
     }
 
+    void on_end_of_simulation(function<void(void)> callback) {
+        helper_module& helper = helper_module::instance();
+        helper.end_of_sim.push_back(callback);
+    }
+
     void on_each_delta_cycle(function<void(void)> callback) {
         helper_module& helper = helper_module::instance();
-        helper.deltas.push_back(callback);
+        helper.deltas.push_back({callback, nullptr});
     }
 
     void on_each_time_step(function<void(void)> callback) {
         helper_module& helper = helper_module::instance();
-        helper.tsteps.push_back(callback);
+        helper.tsteps.push_back({callback, nullptr});
+    }
+
+    void on_each_delta_cycle(function<void(void)> callback,
+                             const atomic<bool>& pending) {
+        helper_module& helper = helper_module::instance();
+        helper.deltas.push_back({callback, &pending});
+    }
+
+    void on_each_time_step(function<void(void)> callback,
+                           const atomic<bool>& pending) {
+        helper_module& helper = helper_module::instance();
+        helper.tsteps.push_back({callback, &pending});
+    }
+
+    u64 sim_delta_cycles() {
+        return helper_module::instance().num_deltas;
+    }
+
+    u64 sim_time_steps() {
+        return helper_module::instance().num_tsteps;
     }
 
     timer::timer(function<void(timer&)> cb):
-        m_triggers(0), m_timeout(), m_event(nullptr), m_cb(std::move(cb)) {
+        m_triggers(0), m_timeout(), m_slot(NO_SLOT), m_prev(nullptr),
+        m_next(nullptr), m_cb(std::move(cb)) {
     }
 
     timer::~timer() {
@@ -371,45 +567,53 @@ namespace vcml {
     }
 
     void timer::trigger() {
-        m_event = nullptr;
+        cancel();
         m_triggers++;
         m_cb(*this);
     }
 
     void timer::cancel() {
-        if (m_event) {
-            m_event->owner = nullptr;
-            m_event = nullptr;
-        }
+        if (is_pending())
+            helper_module::instance().remove_timer(this);
     }
 
     void timer::reset(const sc_time& delta) {
+        thctl_guard guard;
         cancel();
 
-        m_event = new event;
-        m_event->owner = this;
-        m_event->timeout = m_timeout = sc_time_stamp() + delta;
-        helper_module::instance().add_timer(m_event);
+        m_timeout = sc_time_stamp() + delta;
+        helper_module::instance().add_timer(this);
     }
 
     __thread struct async_worker* g_async = nullptr;
 
     struct async_worker
     {
+        struct request {
+            function<void(void)> job;
+            bool* done;
+        };
+
         const size_t id;
         sc_process_b* const process;
 
-        atomic<bool> alive;
-        atomic<bool> working;
+        bool alive;
+        bool working;
         function<void(void)> task;
 
         atomic<u64> progress;
-        atomic<function<void(void)>*> request;
+        deque<request> requests;
 
         mutex mtx;
-        condition_variable_any notify;
+        condition_variable notify;    // wakes up the worker thread
+        condition_variable notify_sc; // wakes up the SystemC thread
+        condition_variable completed; // wakes up waiting sc_sync calls
         thread worker;
 
+        // upper bound for the SystemC thread to sleep while the worker is
+        // busy, so that critical sections still get served in between
+        static constexpr std::chrono::microseconds idle_timeout{100};
+
         async_worker(size_t _id, sc_process_b* _proc):
             id(_id),
             process(_proc),
@@ -417,9 +621,11 @@ namespace vcml {
             working(false),
             task(),
             progress(0),
-            request(nullptr),
+            requests(),
             mtx(),
             notify(),
+            notify_sc(),
+            completed(),
             worker(std::bind(&async_worker::work, this)) {
             VCML_ERROR_ON(!process, "invalid parent process");
             set_thread_name(worker, mkstr("vcml_async_%zu", id));
@@ -427,7 +633,11 @@ namespace vcml {
 
         ~async_worker() {
             if (worker.joinable()) {
-                alive = false;
+                {
+                    lock_guard<mutex> guard(mtx);
+                    alive = false;
+                }
+
                 notify.notify_all();
                 worker.join();
             }
@@ -436,55 +646,105 @@ namespace vcml {
         void work() {
             g_async = this;
 
-            mtx.lock();
+            std::unique_lock<mutex> lock(mtx);
             while (alive) {
-                while (alive && !working)
-                    notify.wait(mtx);
+                notify.wait(lock, [&]() -> bool {
+                    return !alive || working;
+                });
 
                 if (!alive)
                     break;
 
+                lock.unlock();
                 task();
+                lock.lock();
+
                 working = false;
+                notify_sc.notify_all();
             }
 
             g_async = nullptr;
         }
 
-        static void yield() {
-#if defined(__x86_64__)
-            asm volatile ("pause" ::: "memory");
-#elif defined(__aarch64__)
-            asm volatile ("yield" ::: "memory");
-#endif
+        bool has_work() const {
+            return !requests.empty() || progress > 0 || !working;
+        }
+
+        size_t run_requests() {
+            deque<request> batch;
+
+            {
+                lock_guard<mutex> guard(mtx);
+                batch.swap(requests);
+            }
+
+            for (request& req : batch)
+                req.job();
+
+            lock_guard<mutex> guard(mtx);
+            for (request& req : batch)
+                if (req.done != nullptr)
+                    *req.done = true;
+            completed.notify_all();
+
+            return batch.size();
+        }
+
+        void idle() {
+            if (!sc_core::sc_pending_activity_at_current_time()) {
+                std::unique_lock<mutex> lock(mtx);
+                notify_sc.wait_for(lock, idle_timeout, [&]() -> bool {
+                    return has_work();
+                });
+            }
+
+            sc_core::wait(SC_ZERO_TIME);
         }
 
         void run_async(function<void(void)>& job) {
-            mtx.lock();
-            task = job;
-            working = true;
-            mtx.unlock();
+            {
+                lock_guard<mutex> guard(mtx);
+                task = job;
+                working = true;
+            }
+
             notify.notify_all();
 
-            while (working) {
+            while (true) {
                 u64 p = progress.exchange(0);
-                sc_core::wait(time_from_value(p));
+                if (p > 0)
+                    sc_core::wait(time_from_value(p));
 
-                if (request) {
-                    (*request)();
-                    request = nullptr;
+                size_t n = run_requests();
+
+                {
+                    lock_guard<mutex> guard(mtx);
+                    if (!working && requests.empty() && progress == 0)
+                        break;
                 }
-            }
 
-            u64 p = progress.exchange(0);
-            if (p > 0)
-                sc_core::wait(time_from_value(p));
+                if (p == 0 && n == 0)
+                    idle();
+            }
         }
 
         void run_sync(function<void(void)> job) {
-            g_async->request = &job;
-            while (g_async->request)
-                yield();
+            bool done = false;
+            std::unique_lock<mutex> lock(mtx);
+            requests.push_back({std::move(job), &done});
+            notify_sc.notify_all();
+            completed.wait(lock, [&]() -> bool { return done; });
+        }
+
+        void post(function<void(void)> job) {
+            lock_guard<mutex> guard(mtx);
+            requests.push_back({std::move(job), nullptr});
+            notify_sc.notify_all();
+        }
+
+        void add_progress(u64 delta) {
+            if (progress.fetch_add(delta) == 0)
+                notify_sc.notify_all();
         }
 
         static async_worker& lookup(sc_process_b* thread) {
@@ -503,6 +763,8 @@ namespace vcml {
         }
     };
 
+    constexpr std::chrono::microseconds async_worker::idle_timeout;
+
     void sc_async(function<void(void)> job) {
         auto thread = current_thread();
         VCML_ERROR_ON(!thread, "sc_async must be called from SC_THREAD");
@@ -512,12 +774,12 @@ namespace vcml {
 
     void sc_progress(const sc_time& delta) {
         VCML_ERROR_ON(!g_async, "no async thread to progress");
-        g_async->progress += delta.value();
+        g_async->add_progress(delta.value());
     }
 
     void sc_sync(function<void(void)> job) {
         if (thctl_is_sysc_thread()) {
-           job();
+            job();
         } else if (g_async != nullptr) {
             g_async->run_sync(job);
         } else {
@@ -525,6 +787,16 @@ namespace vcml {
         }
     }
 
+    void sc_post(function<void(void)> job) {
+        if (thctl_is_sysc_thread()) {
+            job();
+        } else if (g_async != nullptr) {
+            g_async->post(std::move(job));
+        } else {
+            VCML_ERROR("not on systemc or async thread");
+        }
+    }
+
     bool sc_is_async() {
         return g_async != nullptr;
     }
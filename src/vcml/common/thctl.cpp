@@ -22,13 +22,18 @@
 
 namespace vcml {
 
+    // depth of resource write guards held by the current thread
+    static thread_local size_t t_resources = 0;
+
     struct thctl {
         std::thread::id sysc_thread;
         std::thread::id curr_owner;
 
         std::mutex mutex;
-        std::atomic<size_t> nwaiting;
-        std::condition_variable_any notify;
+        size_t nwaiting;
+        std::atomic<bool> pending;
+        std::condition_variable notify;
+        size_t nwriters;
 
         thctl();
         ~thctl() = default;
@@ -39,6 +44,9 @@ namespace vcml {
         void enter_critical();
         void exit_critical();
 
+        void enter_resource();
+        void exit_resource();
+
         void suspend();
     };
 
@@ -47,9 +55,10 @@ namespace vcml {
         curr_owner(sysc_thread),
         mutex(),
         nwaiting(0),
-        notify() {
-        mutex.lock();
-        on_each_delta_cycle(std::bind(&thctl::suspend, this));
+        pending(false),
+        notify(),
+        nwriters(0) {
+        on_each_delta_cycle(std::bind(&thctl::suspend, this), pending);
     }
 
     inline bool thctl::is_sysc_thread() const {
@@ -57,7 +66,7 @@ namespace vcml {
     }
 
     inline bool thctl::is_in_critical() const {
-        return std::this_thread::get_id() == curr_owner;
+        return std::this_thread::get_id() == curr_owner || t_resources > 0;
     }
 
     inline void thctl::enter_critical() {
@@ -66,30 +75,67 @@ namespace vcml {
         if (is_in_critical())
             VCML_ERROR("thread already in critical section");
 
+        std::unique_lock<std::mutex> lock(mutex);
         nwaiting++;
-        mutex.lock();
+        pending = true;
+
+        // curr_owner is only cleared while SystemC is suspended
+        notify.wait(lock, [&]() -> bool {
+            return curr_owner == std::thread::id() && nwriters == 0;
+        });
+
         curr_owner = std::this_thread::get_id();
     }
 
     inline void thctl::exit_critical() {
+        std::lock_guard<std::mutex> guard(mutex);
         if (curr_owner != std::this_thread::get_id())
             VCML_ERROR("thread not in critical section");
 
         curr_owner = std::thread::id();
-        mutex.unlock();
+        pending = --nwaiting > 0;
+        notify.notify_all();
+    }
 
-        if (--nwaiting == 0)
-            notify.notify_all();
+    inline void thctl::enter_resource() {
+        if (is_sysc_thread())
+            VCML_ERROR("SystemC thread must not enter critical sections");
+
+        std::unique_lock<std::mutex> lock(mutex);
+        nwaiting++;
+        pending = true;
+
+        notify.wait(lock, [&]() -> bool {
+            return curr_owner == std::thread::id();
+        });
+
+        nwriters++;
+        t_resources++;
+    }
+
+    inline void thctl::exit_resource() {
+        std::lock_guard<std::mutex> guard(mutex);
+        if (t_resources == 0)
+            VCML_ERROR("thread not writing any resource");
+
+        t_resources--;
+        nwriters--;
+        pending = --nwaiting > 0;
+        notify.notify_all();
     }
 
     void thctl::suspend() {
         VCML_ERROR_ON(!is_sysc_thread(), "this is not the SystemC thread");
-        VCML_ERROR_ON(!is_in_critical(), "thread not in critical section");
 
-        if (nwaiting == 0)
+        if (!pending)
             return;
 
-        notify.wait(mutex, [&]() -> bool {
+        std::unique_lock<std::mutex> lock(mutex);
+        VCML_ERROR_ON(curr_owner != sysc_thread, "thread not in critical");
+
+        curr_owner = std::thread::id();
+        notify.notify_all();
+        notify.wait(lock, [&]() -> bool {
             return nwaiting == 0;
         });
 
@@ -120,4 +166,55 @@ namespace vcml {
         g_thctl.suspend();
     }
 
+    void thctl_enter_resource() {
+        if (sim_running())
+            g_thctl.enter_resource();
+    }
+
+    void thctl_exit_resource() {
+        if (sim_running())
+            g_thctl.exit_resource();
+    }
+
+    thctl_resource::thctl_resource(bool sysc_access):
+        m_mtx(),
+        m_cv(),
+        m_readers(0),
+        m_waiting(0),
+        m_writer(false),
+        m_sysc_access(sysc_access) {
+    }
+
+    void thctl_resource::lock_shared() {
+        std::unique_lock<mutex> lock(m_mtx);
+        m_cv.wait(lock, [&]() -> bool {
+            return !m_writer && m_waiting == 0;
+        });
+
+        m_readers++;
+    }
+
+    void thctl_resource::unlock_shared() {
+        lock_guard<mutex> guard(m_mtx);
+        if (--m_readers == 0)
+            m_cv.notify_all();
+    }
+
+    void thctl_resource::lock() {
+        std::unique_lock<mutex> lock(m_mtx);
+        m_waiting++;
+        m_cv.wait(lock, [&]() -> bool {
+            return !m_writer && m_readers == 0;
+        });
+
+        m_waiting--;
+        m_writer = true;
+    }
+
+    void thctl_resource::unlock() {
+        lock_guard<mutex> guard(m_mtx);
+        m_writer = false;
+        m_cv.notify_all();
+    }
+
 }
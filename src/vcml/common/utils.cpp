@@ -111,6 +111,13 @@ namespace vcml {
         return tp.tv_sec * 1000000ul + tp.tv_nsec / 1000ul;
     }
 
+    u64 timestamp_ns() {
+        struct timespec tp = {};
+        if (clock_gettime(CLOCK_MONOTONIC, &tp))
+            VCML_ERROR("cannot read clock: %s (%d)", strerror(errno), errno);
+        return tp.tv_sec * 1000000000ul + tp.tv_nsec;
+    }
+
     size_t fd_peek(int fd, time_t timeoutms) {
         if (fd < 0)
             return 0;
@@ -0,0 +1,504 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+#include "vcml/debugging/condition.h"
+#include "vcml/debugging/target.h"
+
+namespace vcml { namespace debugging {
+
+    static size_t operand_size(u8 op) {
+        switch (op) {
+        case condition::OP_EXT:
+        case condition::OP_ZERO_EXT:
+        case condition::OP_PICK:
+        case condition::OP_CONST8:
+            return 1;
+
+        case condition::OP_IF_GOTO:
+        case condition::OP_GOTO:
+        case condition::OP_CONST16:
+        case condition::OP_REG:
+            return 2;
+
+        case condition::OP_CONST32:
+            return 4;
+
+        case condition::OP_CONST64:
+            return 8;
+
+        default:
+            return 0;
+        }
+    }
+
+    static bool is_supported(u8 op) {
+        switch (op) {
+        case condition::OP_ADD:
+        case condition::OP_SUB:
+        case condition::OP_MUL:
+        case condition::OP_DIV_SIGNED:
+        case condition::OP_DIV_UNSIGNED:
+        case condition::OP_REM_SIGNED:
+        case condition::OP_REM_UNSIGNED:
+        case condition::OP_LSH:
+        case condition::OP_RSH_SIGNED:
+        case condition::OP_RSH_UNSIGNED:
+        case condition::OP_LOG_NOT:
+        case condition::OP_BIT_AND:
+        case condition::OP_BIT_OR:
+        case condition::OP_BIT_XOR:
+        case condition::OP_BIT_NOT:
+        case condition::OP_EQUAL:
+        case condition::OP_LESS_SIGNED:
+        case condition::OP_LESS_UNSIGNED:
+        case condition::OP_EXT:
+        case condition::OP_REF8:
+        case condition::OP_REF16:
+        case condition::OP_REF32:
+        case condition::OP_REF64:
+        case condition::OP_IF_GOTO:
+        case condition::OP_GOTO:
+        case condition::OP_CONST8:
+        case condition::OP_CONST16:
+        case condition::OP_CONST32:
+        case condition::OP_CONST64:
+        case condition::OP_REG:
+        case condition::OP_END:
+        case condition::OP_DUP:
+        case condition::OP_POP:
+        case condition::OP_ZERO_EXT:
+        case condition::OP_SWAP:
+        case condition::OP_PICK:
+        case condition::OP_ROT:
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    static u64 fetch(const vector<u8>& code, size_t pos, size_t size) {
+        u64 val = 0;
+        for (size_t i = 0; i < size; i++)
+            val = val << 8 | code[pos + i];
+        return val;
+    }
+
+    static void emit(vector<u8>& code, u8 op, u64 val = 0) {
+        code.push_back(op);
+        for (size_t i = operand_size(op); i > 0; i--)
+            code.push_back((u8)(val >> ((i - 1) * 8)));
+    }
+
+    static u64 sign_extend(u64 val, u64 bits) {
+        if (bits == 0 || bits >= 64)
+            return val;
+        u64 shift = 64 - bits;
+        return (u64)((i64)(val << shift) >> shift);
+    }
+
+    static u64 zero_extend(u64 val, u64 bits) {
+        if (bits == 0 || bits >= 64)
+            return val;
+        return val & ((1ull << bits) - 1);
+    }
+
+    static bool read_memory(target& tgt, u64 addr, size_t size, u64& val) {
+        u8 buf[8];
+        if (tgt.read_vmem_dbg(addr, buf, size) != size)
+            return false;
+
+        val = 0;
+        if (tgt.is_big_endian()) {
+            for (size_t i = 0; i < size; i++)
+                val = val << 8 | buf[i];
+        } else {
+            for (size_t i = size; i > 0; i--)
+                val = val << 8 | buf[i - 1];
+        }
+
+        return true;
+    }
+
+    bool condition::execute(const program& prog, target& tgt, u64& result) {
+        const vector<u8>& code = prog.code;
+        u64 stack[MAX_STACK];
+        size_t sp = 0;
+        size_t pc = 0;
+
+        for (size_t steps = 0; steps < MAX_STEPS; steps++) {
+            if (pc >= code.size())
+                return false;
+
+            u8 op = code[pc++];
+            size_t len = operand_size(op);
+            u64 arg = fetch(code, pc, len);
+            pc += len;
+
+            u64 a, b;
+            switch (op) {
+            case OP_ADD:
+            case OP_SUB:
+            case OP_MUL:
+            case OP_DIV_SIGNED:
+            case OP_DIV_UNSIGNED:
+            case OP_REM_SIGNED:
+            case OP_REM_UNSIGNED:
+            case OP_LSH:
+            case OP_RSH_SIGNED:
+            case OP_RSH_UNSIGNED:
+            case OP_BIT_AND:
+            case OP_BIT_OR:
+            case OP_BIT_XOR:
+            case OP_EQUAL:
+            case OP_LESS_SIGNED:
+            case OP_LESS_UNSIGNED:
+                if (sp < 2)
+                    return false;
+
+                b = stack[--sp];
+                a = stack[sp - 1];
+
+                switch (op) {
+                case OP_ADD: a = a + b; break;
+                case OP_SUB: a = a - b; break;
+                case OP_MUL: a = a * b; break;
+                case OP_LSH: a = b < 64 ? a << b : 0; break;
+                case OP_RSH_UNSIGNED: a = b < 64 ? a >> b : 0; break;
+                case OP_RSH_SIGNED: a = (u64)((i64)a >> min<u64>(b, 63));
+                    break;
+                case OP_BIT_AND: a = a & b; break;
+                case OP_BIT_OR: a = a | b; break;
+                case OP_BIT_XOR: a = a ^ b; break;
+                case OP_EQUAL: a = a == b; break;
+                case OP_LESS_SIGNED: a = (i64)a < (i64)b; break;
+                case OP_LESS_UNSIGNED: a = a < b; break;
+                default:
+                    if (b == 0)
+                        return false;
+                    if (b == ~0ull && op == OP_DIV_SIGNED)
+                        a = -a; // avoid trapping on INT64_MIN / -1
+                    else if (b == ~0ull && op == OP_REM_SIGNED)
+                        a = 0;
+                    else if (op == OP_DIV_SIGNED)
+                        a = (u64)((i64)a / (i64)b);
+                    else if (op == OP_DIV_UNSIGNED)
+                        a = a / b;
+                    else if (op == OP_REM_SIGNED)
+                        a = (u64)((i64)a % (i64)b);
+                    else
+                        a = a % b;
+                    break;
+                }
+
+                stack[sp - 1] = a;
+                break;
+
+            case OP_LOG_NOT:
+            case OP_BIT_NOT:
+            case OP_EXT:
+            case OP_ZERO_EXT:
+                if (sp < 1)
+                    return false;
+
+                a = stack[sp - 1];
+                if (op == OP_LOG_NOT)
+                    a = !a;
+                else if (op == OP_BIT_NOT)
+                    a = ~a;
+                else if (op == OP_EXT)
+                    a = sign_extend(a, arg);
+                else
+                    a = zero_extend(a, arg);
+
+                stack[sp - 1] = a;
+                break;
+
+            case OP_REF8:
+            case OP_REF16:
+            case OP_REF32:
+            case OP_REF64:
+                if (sp < 1)
+                    return false;
+                if (!read_memory(tgt, stack[sp - 1], 1 << (op - OP_REF8),
+                                 stack[sp - 1])) {
+                    return false;
+                }
+                break;
+
+            case OP_IF_GOTO:
+                if (sp < 1)
+                    return false;
+                if (stack[--sp] != 0)
+                    pc = arg;
+                break;
+
+            case OP_GOTO:
+                pc = arg;
+                break;
+
+            case OP_CONST8:
+            case OP_CONST16:
+            case OP_CONST32:
+            case OP_CONST64:
+                if (sp >= MAX_STACK)
+                    return false;
+                stack[sp++] = arg;
+                break;
+
+            case OP_REG:
+                if (sp >= MAX_STACK)
+                    return false;
+                if (!tgt.read_cpureg_dbg(*prog.regs[arg], stack[sp]))
+                    return false;
+                sp++;
+                break;
+
+            case OP_END:
+                if (sp < 1)
+                    return false;
+                result = stack[sp - 1];
+                return true;
+
+            case OP_DUP:
+                if (sp < 1 || sp >= MAX_STACK)
+                    return false;
+                stack[sp] = stack[sp - 1];
+                sp++;
+                break;
+
+            case OP_POP:
+                if (sp < 1)
+                    return false;
+                sp--;
+                break;
+
+            case OP_SWAP:
+                if (sp < 2)
+                    return false;
+                std::swap(stack[sp - 1], stack[sp - 2]);
+                break;
+
+            case OP_PICK:
+                if (arg >= sp || sp >= MAX_STACK)
+                    return false;
+                stack[sp] = stack[sp - 1 - arg];
+                sp++;
+                break;
+
+            case OP_ROT:
+                if (sp < 3)
+                    return false;
+                a = stack[sp - 1];
+                stack[sp - 1] = stack[sp - 2];
+                stack[sp - 2] = stack[sp - 3];
+                stack[sp - 3] = a;
+                break;
+
+            default:
+                return false;
+            }
+        }
+
+        return false;
+    }
+
+    condition::condition():
+        m_programs() {
+    }
+
+    bool condition::add_agent_expr(const vector<u8>& code,
+        const function<const cpureg*(u64)>& lookup) {
+        if (code.empty())
+            return false;
+
+        program prog;
+        prog.code = code;
+
+        for (size_t pc = 0; pc < code.size(); ) {
+            u8 op = code[pc++];
+            if (!is_supported(op))
+                return false;
+
+            size_t len = operand_size(op);
+            if (pc + len > code.size())
+                return false;
+
+            u64 arg = fetch(code, pc, len);
+
+            switch (op) {
+            case OP_IF_GOTO:
+            case OP_GOTO:
+                if (arg >= code.size())
+                    return false;
+                break;
+
+            case OP_REG: {
+                const cpureg* reg = lookup(arg);
+                if (reg == nullptr || !reg->is_readable())
+                    return false;
+
+                // rewrite register number into an index into prog.regs
+                u64 idx = prog.regs.size();
+                prog.regs.push_back(reg);
+                prog.code[pc + 0] = (u8)(idx >> 8);
+                prog.code[pc + 1] = (u8)(idx >> 0);
+                break;
+            }
+
+            default:
+                break;
+            }
+
+            pc += len;
+        }
+
+        m_programs.push_back(std::move(prog));
+        return true;
+    }
+
+    static void skip_spaces(const string& s, size_t& pos) {
+        while (pos < s.size() && isspace(s[pos]))
+            pos++;
+    }
+
+    static bool parse_operand(const string& s, size_t& pos, const target& tgt,
+                              vector<u8>& code, vector<const cpureg*>& regs) {
+        skip_spaces(s, pos);
+        if (pos >= s.size())
+            return false;
+
+        static const struct {
+            const char* prefix;
+            u8 op;
+        } refs[] = {
+            { "u8[",  condition::OP_REF8  },
+            { "u16[", condition::OP_REF16 },
+            { "u32[", condition::OP_REF32 },
+            { "u64[", condition::OP_REF64 },
+        };
+
+        for (const auto& ref : refs) {
+            if (s.compare(pos, strlen(ref.prefix), ref.prefix) != 0)
+                continue;
+
+            pos += strlen(ref.prefix);
+            if (!parse_operand(s, pos, tgt, code, regs))
+                return false;
+
+            skip_spaces(s, pos);
+            if (pos >= s.size() || s[pos++] != ']')
+                return false;
+
+            emit(code, ref.op);
+            return true;
+        }
+
+        if (isdigit(s[pos])) {
+            const char* start = s.c_str() + pos;
+            char* end = nullptr;
+            u64 val = strtoull(start, &end, 0);
+            pos += end - start;
+            emit(code, condition::OP_CONST64, val);
+            return true;
+        }
+
+        size_t end = pos;
+        while (end < s.size() && (isalnum(s[end]) || s[end] == '_' ||
+                                  s[end] == '.')) {
+            end++;
+        }
+
+        if (end == pos)
+            return false;
+
+        const cpureg* reg = tgt.find_cpureg(s.substr(pos, end - pos));
+        if (reg == nullptr || !reg->is_readable())
+            return false;
+
+        emit(code, condition::OP_REG, regs.size());
+        regs.push_back(reg);
+        pos = end;
+        return true;
+    }
+
+    bool condition::add_expression(const string& expr, const target& tgt) {
+        program prog;
+        size_t pos = 0;
+
+        if (!parse_operand(expr, pos, tgt, prog.code, prog.regs))
+            return false;
+
+        skip_spaces(expr, pos);
+        if (pos < expr.size()) {
+            static const struct {
+                const char* name;
+                vector<u8> ops;
+            } binops[] = {
+                { "==", { OP_EQUAL } },
+                { "!=", { OP_EQUAL, OP_LOG_NOT } },
+                { "<=", { OP_SWAP, OP_LESS_UNSIGNED, OP_LOG_NOT } },
+                { ">=", { OP_LESS_UNSIGNED, OP_LOG_NOT } },
+                { "<",  { OP_LESS_UNSIGNED } },
+                { ">",  { OP_SWAP, OP_LESS_UNSIGNED } },
+                { "&",  { OP_BIT_AND } },
+            };
+
+            const vector<u8>* ops = nullptr;
+            for (const auto& binop : binops) {
+                size_t len = strlen(binop.name);
+                if (expr.compare(pos, len, binop.name) == 0) {
+                    ops = &binop.ops;
+                    pos += len;
+                    break;
+                }
+            }
+
+            if (ops == nullptr)
+                return false;
+
+            if (!parse_operand(expr, pos, tgt, prog.code, prog.regs))
+                return false;
+
+            prog.code.insert(prog.code.end(), ops->begin(), ops->end());
+        }
+
+        skip_spaces(expr, pos);
+        if (pos != expr.size())
+            return false;
+
+        emit(prog.code, OP_END);
+        m_programs.push_back(std::move(prog));
+        return true;
+    }
+
+    bool condition::evaluate(target& tgt) const {
+        if (m_programs.empty())
+            return true;
+
+        // evaluation errors count as a hit, so that the user gets to see
+        // why a condition could not be checked
+        for (const program& prog : m_programs) {
+            u64 result = 0;
+            if (!execute(prog, tgt, result) || result != 0)
+                return true;
+        }
+
+        return false;
+    }
+
+}}
@@ -71,7 +71,6 @@ namespace vcml { namespace debugging {
             break;
 
         case GDB_STEPPING:
-            m_target.request_singlestep(this);
             resume();
             break;
 
@@ -86,35 +85,169 @@ namespace vcml { namespace debugging {
             VCML_ERROR("illegal gdb status: %u", status);
         }
 
+        lock_guard<mutex> lock(m_status_mtx);
         m_status = status;
+        m_status_cv.notify_all();
     }
 
-    void gdbserver::notify_step_complete(target& tgt) {
+    u64 gdbserver::thread_id(const target& tgt) const {
+        for (size_t i = 0; i < m_targets.size(); i++)
+            if (m_targets[i] == &tgt)
+                return i + 1;
+        return 0;
+    }
+
+    target* gdbserver::find_thread(i64 tid) const {
+        if (tid < 1 || tid > (i64)m_targets.size())
+            return nullptr;
+        return m_targets[tid - 1];
+    }
+
+    string gdbserver::stop_reply(const target& tgt, int signal) const {
+        return mkstr("T%02xthread:%lx;", signal, thread_id(tgt));
+    }
+
+    void gdbserver::notify_stop(target& tgt) {
+        if (!m_nonstop) {
+            m_stopped = &tgt;
+            update_status(GDB_STOPPED);
+            return;
+        }
+
+        // non-stop mode: only halt the target that caused the event
+        tgt.request_halt();
+        queue_stop(stop_reply(tgt, GDBSIG_TRAP));
+    }
+
+    void gdbserver::queue_stop(const string& reply) {
+        lock_guard<mutex> lock(m_stop_mtx);
+        if (!is_connected())
+            return;
+
+        m_stops.push(reply);
+        if (m_notified)
+            return; // gdb will collect this one via vStopped
+
+        m_notified = true;
+        send_notification("Stop:" + reply);
+    }
+
+    void gdbserver::set_nonstop(bool nonstop) {
+        if (m_nonstop == nonstop)
+            return;
+
+        if (nonstop) {
+            for (target* tgt : m_targets)
+                tgt->request_halt();
+            m_nonstop = true;
+            update_status(GDB_RUNNING);
+        } else {
+            update_status(GDB_STOPPED);
+            m_nonstop = false;
+            for (target* tgt : m_targets)
+                tgt->request_resume();
+        }
+
+        lock_guard<mutex> lock(m_stop_mtx);
+        m_stops = queue<string>();
+        m_notified = false;
+    }
+
+    void gdbserver::handle_signal(int signal) {
+        lock_guard<mutex> lock(m_status_mtx);
+        m_signal = signal;
+        m_status_cv.notify_all();
+    }
+
+    string gdbserver::run_until_stop(gdb_status status) {
+        m_signal = 0;
+        update_status(status);
+
+        // sleep until the target stops or gdb sends a break, the timeout
+        // only serves to notice the end of simulation
+        notify_signal(std::bind(&gdbserver::handle_signal, this,
+                                std::placeholders::_1));
+
+        std::unique_lock<mutex> lock(m_status_mtx);
+        while (sim_running() && m_status == status && m_signal == 0)
+            m_status_cv.wait_for(lock, std::chrono::seconds(1));
+        lock.unlock();
+
+        cancel_signal();
+        if (m_signal != 0)
+            log_debug("received signal %d", m_signal);
+
         update_status(GDB_STOPPED);
+        for (target* tgt : m_targets)
+            tgt->cancel_singlestep(this);
+
+        return stop_reply(*m_stopped, GDBSIG_TRAP);
+    }
+
+    void gdbserver::notify_step_complete(target& tgt) {
+        notify_stop(tgt);
     }
 
     void gdbserver::notify_breakpoint_hit(const breakpoint& bp) {
-        update_status(GDB_STOPPED);
+        notify_stop(bp.owner());
     }
 
     void gdbserver::notify_watchpoint_read(const watchpoint& wp,
                                            const range& addr) {
-        update_status(GDB_STOPPED);
+        notify_stop(wp.owner());
     }
 
     void gdbserver::notify_watchpoint_write(const watchpoint& wp,
                                             const range& addr,
                                             u64 newval) {
-        update_status(GDB_STOPPED);
+        notify_stop(wp.owner());
     }
 
     const cpureg* gdbserver::lookup_cpureg(unsigned int gdbno) {
-        auto it = m_allregs.find(gdbno);
-        if (it == m_allregs.end())
+        const auto& regs = m_allregs[m_gtarget];
+        auto it = regs.find(gdbno);
+        if (it == regs.end())
             return nullptr;
         return it->second;
     }
 
+    bool gdbserver::parse_condition(const char* command, const target* tgt,
+                                    condition& cond) {
+        const auto& regs = m_allregs[tgt];
+        auto lookup = [&regs](u64 gdbno) -> const cpureg* {
+            auto it = regs.find(gdbno);
+            return it != regs.end() ? it->second : nullptr;
+        };
+
+        // conditions are appended as ";X<len>,<bytecode>" to Z0 and Z1
+        for (const char* s = strchr(command, ';'); s; s = strchr(s, ';')) {
+            s++;
+            if (strncmp(s, "cmds:", strlen("cmds:")) == 0)
+                break; // breakpoint commands are not supported
+
+            if (*s++ != 'X')
+                return false;
+
+            char* end = nullptr;
+            size_t len = strtoul(s, &end, 16);
+            if (end == s || *end != ',')
+                return false;
+
+            s = end + 1;
+            if (strnlen(s, 2 * len) < 2 * len)
+                return false;
+
+            vector<u8> code(len);
+            for (size_t i = 0; i < len; i++, s += 2)
+                code[i] = char2int(s[0]) << 4 | char2int(s[1]);
+
+            if (!cond.add_agent_expr(code, lookup))
+                return false;
+        }
+
+        return true;
+    }
+
     gdbserver::handler gdbserver::find_handler(const char* command) {
         if (!stl_contains(m_handler, command[0]))
             return &gdbserver::handle_unknown;
@@ -126,31 +259,21 @@ namespace vcml { namespace debugging {
     }
 
     string gdbserver::handle_step(const char* command) {
-        update_status(GDB_STEPPING);
-        while (sim_running() && is_stepping()) {
-            int signal = 0;
-            if ((signal = recv_signal(100))) {
-                log_debug("received signal %d", signal);
-                break;
-            }
-        }
+        target* tgt = m_ctarget ? m_ctarget : m_gtarget;
+        for (target* t : m_targets)
+            t->request_resume();
 
-        update_status(GDB_STOPPED);
-        return mkstr("S%02x", GDBSIG_TRAP);
+        m_stopped = tgt;
+        tgt->request_singlestep(this);
+        return run_until_stop(GDB_STEPPING);
     }
 
     string gdbserver::handle_continue(const char* command) {
-        update_status(GDB_RUNNING);
-        while (sim_running() && is_running()) {
-            int signal = 0;
-            if ((signal = recv_signal(100))) {
-                log_debug("received signal %d", signal);
-                break;
-            }
-        }
+        for (target* t : m_targets)
+            t->request_resume();
 
-        update_status(GDB_STOPPED);
-        return mkstr("S%02x", GDBSIG_TRAP);
+        m_stopped = m_ctarget ? m_ctarget : m_gtarget;
+        return run_until_stop(GDB_RUNNING);
     }
 
     string gdbserver::handle_detach(const char* command) {
@@ -167,6 +290,7 @@ namespace vcml { namespace debugging {
     string gdbserver::handle_query(const char* command) {
         if (strncmp(command, "qSupported", strlen("qSupported")) == 0) {
             string features = mkstr("PacketSize=%zx;", PACKET_SIZE);
+            features += "QStartNoAckMode+;QNonStop+;ConditionalBreakpoints+;";
             if (m_target_arch != nullptr)
                 features += "qXfer:features:read+;";
             return features;
@@ -180,12 +304,34 @@ namespace vcml { namespace debugging {
             return handle_rcmd(command);
         if (strncmp(command, "qXfer", strlen("qXfer")) == 0)
             return handle_xfer(command);
+        if (strcmp(command, "qC") == 0)
+            return mkstr("QC%lx", thread_id(*m_gtarget));
+        if (strncmp(command, "qfThreadInfo", strlen("qfThreadInfo")) == 0)
+            return handle_thread_info(command);
+        if (strncmp(command, "qsThreadInfo", strlen("qsThreadInfo")) == 0)
+            return "l";
+        if (strncmp(command, "qThreadExtraInfo", 16) == 0)
+            return handle_thread_info(command);
+
+        return handle_unknown(command);
+    }
+
+    string gdbserver::handle_set(const char* command) {
+        if (strcmp(command, "QNonStop:1") == 0) {
+            set_nonstop(true);
+            return "OK";
+        }
+
+        if (strcmp(command, "QNonStop:0") == 0) {
+            set_nonstop(false);
+            return "OK";
+        }
 
         return handle_unknown(command);
     }
 
     string gdbserver::handle_rcmd(const char* command) {
-        module* mod = dynamic_cast<module*>(&m_target);
+        module* mod = dynamic_cast<module*>(m_gtarget);
         if (mod == nullptr)
             return ERR_COMMAND;
 
@@ -219,7 +365,7 @@ namespace vcml { namespace debugging {
         if (object == "features" && annex == "target.xml") {
             if (m_target_xml.empty()) {
                 stringstream ss;
-                m_target_arch->write_xml(m_target, ss);
+                m_target_arch->write_xml(*m_targets.front(), ss);
                 m_target_xml = ss.str();
             }
 
@@ -236,6 +382,31 @@ namespace vcml { namespace debugging {
         return "";
     }
 
+    string gdbserver::handle_thread_info(const char* command) {
+        if (command[1] == 'f') {
+            string threads = "m";
+            for (size_t i = 0; i < m_targets.size(); i++)
+                threads += mkstr(i ? ",%zx" : "%zx", i + 1);
+            return threads;
+        }
+
+        const char* param = strchr(command, ',');
+        if (param == nullptr)
+            return ERR_COMMAND;
+
+        target* tgt = find_thread(strtoll(param + 1, nullptr, 16));
+        if (tgt == nullptr)
+            return ERR_PARAM;
+
+        string info = tgt->target_name();
+        if (m_nonstop)
+            info += tgt->is_halted() ? " (halted)" : " (running)";
+
+        string result;
+        hex_encode(result, (const u8*)info.c_str(), info.length());
+        return result;
+    }
+
     string gdbserver::handle_reg_read(const char* command) {
         unsigned int regno;
         if (sscanf(command, "p%x", &regno) != 1) {
@@ -248,15 +419,12 @@ namespace vcml { namespace debugging {
             return "xxxxxxxx"; // respond with "contents unknown"
 
         u64 val = reg->read();
-        if (!m_target.is_host_endian())
+        if (!m_gtarget->is_host_endian())
             memswap(&val, reg->size);
 
-        stringstream ss;
-        ss << std::hex << std::setfill('0');
-        for (u32 shift = 0; shift < reg->width(); shift += 8)
-            ss << std::setw(2) << ((val >> shift) & 0xff);
-
-        return ss.str();
+        string result;
+        hex_encode(result, val, reg->size);
+        return result;
     }
 
     string gdbserver::handle_reg_write(const char* command) {
@@ -289,7 +457,7 @@ namespace vcml { namespace debugging {
             }
         }
 
-        if (!m_target.is_host_endian())
+        if (!m_gtarget->is_host_endian())
             memswap(val.ptr, reg->size);
 
         reg->write(val.val);
@@ -297,27 +465,26 @@ namespace vcml { namespace debugging {
     }
 
     string gdbserver::handle_reg_read_all(const char* command) {
-        stringstream ss;
-        ss << std::hex << std::setfill('0');
+        string result;
+        result.reserve(m_cpuregs[m_gtarget].size() * 2 * sizeof(u64));
 
-        for (const cpureg* reg : m_cpuregs) {
+        for (const cpureg* reg : m_cpuregs[m_gtarget]) {
             if (!reg->is_readable())
                 continue;
 
             u64 val = reg->read();
-            if (!m_target.is_host_endian())
+            if (!m_gtarget->is_host_endian())
                 memswap(&val, reg->size);
 
-            for (u32 shift = 0; shift < reg->width(); shift += 8)
-                ss << std::setw(2) << ((val >> shift) & 0xff);
+            hex_encode(result, val, reg->size);
         }
 
-        return ss.str();
+        return result;
     }
 
     string gdbserver::handle_reg_write_all(const char* command) {
         const char* str = command + 1;
-        for (const cpureg* reg : m_cpuregs) {
+        for (const cpureg* reg : m_cpuregs[m_gtarget]) {
             if (!reg->is_writeable())
                 continue;
 
@@ -330,7 +497,7 @@ namespace vcml { namespace debugging {
             for (u64 byte = 0; byte < reg->size; byte++, str += 2)
                 sscanf(str, "%02hhx", val.ptr + byte);
 
-            if (!m_target.is_host_endian())
+            if (!m_gtarget->is_host_endian())
                 memswap(val.ptr, reg->size);
 
             reg->write(val.val);
@@ -351,17 +518,13 @@ namespace vcml { namespace debugging {
             return ERR_PARAM;
         }
 
-        stringstream ss;
-        ss << std::hex << std::setfill('0');
-
         u8 buffer[BUFFER_SIZE];
-        if (m_target.read_vmem_dbg(addr, buffer, size) != size)
+        if (m_gtarget->read_vmem_dbg(addr, buffer, size) != size)
             return ERR_UNKNOWN;
 
-        for (unsigned int i = 0; i < size; i++)
-            ss << std::setw(2) << (int)buffer[i];
-
-        return ss.str();
+        string result;
+        hex_encode(result, buffer, size);
+        return result;
     }
 
     string gdbserver::handle_mem_write(const char* command) {
@@ -388,7 +551,7 @@ namespace vcml { namespace debugging {
         for (unsigned int i = 0; i < size; i++)
             buffer[i] = str2int(data++, 2);
 
-        if (m_target.write_vmem_dbg(addr, buffer, size) != size)
+        if (m_gtarget->write_vmem_dbg(addr, buffer, size) != size)
             return ERR_UNKNOWN;
 
         return "OK";
@@ -421,12 +584,25 @@ namespace vcml { namespace debugging {
         for (unsigned int i = 0; i < size; i++)
             buffer[i] = char_unescape(data);
 
-        if (m_target.write_vmem_dbg(addr, buffer, size) != size)
+        if (m_gtarget->write_vmem_dbg(addr, buffer, size) != size)
             return ERR_UNKNOWN;
 
         return "OK";
     }
 
+    bool gdbserver::parse_breakpoint_type(u64 type, vcml_access& prot) {
+        switch (type) {
+        case GDB_BREAKPOINT_SW:
+        case GDB_BREAKPOINT_HW: prot = VCML_ACCESS_NONE; return true;
+        case GDB_WATCHPOINT_WRITE: prot = VCML_ACCESS_WRITE; return true;
+        case GDB_WATCHPOINT_READ: prot = VCML_ACCESS_READ; return true;
+        case GDB_WATCHPOINT_ACCESS: prot = VCML_ACCESS_READ_WRITE; return true;
+        default:
+            log_warn("unknown breakpoint type %lu", type);
+            return false;
+        }
+    }
+
     string gdbserver::handle_breakpoint_set(const char* command) {
         unsigned long long type, addr, length;
         if (sscanf(command, "Z%llx,%llx,%llx", &type, &addr, &length) != 3) {
@@ -434,33 +610,39 @@ namespace vcml { namespace debugging {
             return ERR_COMMAND;
         }
 
-        const range wp(addr, addr + length - 1);
-        switch (type) {
-        case GDB_BREAKPOINT_SW:
-        case GDB_BREAKPOINT_HW:
-            if (!m_target.insert_breakpoint(addr, this))
-                return ERR_INTERNAL;
-            break;
+        vcml_access prot;
+        if (!parse_breakpoint_type(type, prot))
+            return ERR_COMMAND;
 
-        case GDB_WATCHPOINT_WRITE:
-            if (!m_target.insert_watchpoint(wp, VCML_ACCESS_WRITE, this))
-                return ERR_INTERNAL;
-            break;
+        bool is_bp = prot == VCML_ACCESS_NONE;
 
-        case GDB_WATCHPOINT_READ:
-            if (!m_target.insert_watchpoint(wp, VCML_ACCESS_READ, this))
-                return ERR_INTERNAL;
-            break;
+        // breakpoints and watchpoints apply to all threads, gdb considers
+        // them inserted everywhere or nowhere
+        vector<condition> conds(m_targets.size());
+        for (size_t i = 0; is_bp && i < m_targets.size(); i++) {
+            if (!parse_condition(command, m_targets[i], conds[i])) {
+                log_warn("unsupported breakpoint condition '%s'", command);
+                return ERR_PARAM;
+            }
+        }
 
+        const range wp(addr, addr + length - 1);
+        for (size_t i = 0; i < m_targets.size(); i++) {
+            target* tgt = m_targets[i];
+            bool ok = is_bp
+                ? tgt->insert_breakpoint(addr, this, conds[i]) != nullptr
+                : tgt->insert_watchpoint(wp, prot, this);
+            if (ok)
+                continue;
 
-        case GDB_WATCHPOINT_ACCESS:
-            if (!m_target.insert_watchpoint(wp, VCML_ACCESS_READ_WRITE, this))
-                return ERR_INTERNAL;
-            break;
+            while (i-- > 0) {
+                if (is_bp)
+                    m_targets[i]->remove_breakpoint(addr, this);
+                else
+                    m_targets[i]->remove_watchpoint(wp, prot, this);
+            }
 
-        default:
-            log_warn("unknown breakpoint type %llu", type);
-            return ERR_COMMAND;
+            return ERR_INTERNAL;
         }
 
         return "OK";
@@ -473,81 +655,260 @@ namespace vcml { namespace debugging {
             return ERR_COMMAND;
         }
 
+        vcml_access prot;
+        if (!parse_breakpoint_type(type, prot))
+            return ERR_COMMAND;
+
+        bool is_bp = prot == VCML_ACCESS_NONE;
+
+        // only remove if every thread has it, otherwise gdb would keep a
+        // breakpoint that is gone on some of them
         const range wp(addr, addr + length - 1);
-        switch (type) {
-        case GDB_BREAKPOINT_SW:
-        case GDB_BREAKPOINT_HW:
-            if (!m_target.remove_breakpoint(addr, this))
+        for (target* tgt : m_targets) {
+            bool found = is_bp ? tgt->find_breakpoint(addr) != nullptr :
+                std::any_of(tgt->watchpoints().begin(),
+                            tgt->watchpoints().end(),
+                            [&wp](const watchpoint* w) -> bool {
+                                return w->address() == wp;
+                            });
+            if (!found)
                 return ERR_INTERNAL;
-            break;
+        }
 
-        case GDB_WATCHPOINT_WRITE:
-            if (!m_target.remove_watchpoint(wp, VCML_ACCESS_WRITE, this))
-                return ERR_INTERNAL;
-            break;
+        bool ok = true;
+        for (target* tgt : m_targets) {
+            if (is_bp)
+                ok &= tgt->remove_breakpoint(addr, this);
+            else
+                ok &= tgt->remove_watchpoint(wp, prot, this);
+        }
 
-        case GDB_WATCHPOINT_READ:
-            if (!m_target.remove_watchpoint(wp, VCML_ACCESS_READ, this))
-                return ERR_INTERNAL;
-            break;
+        return ok ? "OK" : ERR_INTERNAL;
+    }
 
-        case GDB_WATCHPOINT_ACCESS:
-            if (!m_target.remove_watchpoint(wp, VCML_ACCESS_READ_WRITE, this))
-                return ERR_INTERNAL;
-            break;
+    string gdbserver::handle_exception(const char* command) {
+        if (!m_nonstop)
+            return stop_reply(*m_stopped, GDBSIG_TRAP);
+
+        // non-stop mode: report all halted threads, starting with the
+        // first one here and the remaining ones via vStopped
+        lock_guard<mutex> lock(m_stop_mtx);
+        m_stops = queue<string>();
+        for (target* tgt : m_targets)
+            if (tgt->is_halted())
+                m_stops.push(stop_reply(*tgt, GDBSIG_TRAP));
+
+        m_notified = !m_stops.empty();
+        return m_notified ? m_stops.front() : "OK";
+    }
+
+    string gdbserver::handle_thread(const char* command) {
+        char op = command[1];
+        i64 tid = strtoll(command + 2, nullptr, 16);
+
+        target* tgt = find_thread(tid);
+        if (tgt == nullptr && tid > 0)
+            return ERR_PARAM;
+
+        switch (op) {
+        case 'g':
+            if (tgt != nullptr)
+                m_gtarget = tgt;
+            return "OK";
+
+        case 'c':
+            m_ctarget = tgt; // nullptr means all threads
+            return "OK";
 
         default:
-            log_warn("unknown breakpoint type %llu", type);
             return ERR_COMMAND;
         }
-
-        return "OK";
     }
 
-    string gdbserver::handle_exception(const char* command) {
-        return mkstr("S%02u", GDBSIG_TRAP);
+    string gdbserver::handle_thread_alive(const char* command) {
+        i64 tid = strtoll(command + 1, nullptr, 16);
+        return find_thread(tid) ? "OK" : ERR_PARAM;
     }
 
-    string gdbserver::handle_thread(const char* command) {
-        return "OK";
+    string gdbserver::handle_vcmd(const char* command) {
+        if (strncmp(command, "vCont", strlen("vCont")) == 0)
+            return handle_vcont(command);
+        if (strcmp(command, "vStopped") == 0)
+            return handle_vstopped(command);
+        if (strncmp(command, "vKill", strlen("vKill")) == 0) {
+            handle_kill(command);
+            return "OK";
+        }
+
+        return handle_unknown(command);
     }
 
     string gdbserver::handle_vcont(const char* command) {
-        return "";
+        if (strcmp(command, "vCont?") == 0)
+            return "vCont;c;C;s;S;t";
+
+        if (strncmp(command, "vCont;", strlen("vCont;")) != 0)
+            return ERR_COMMAND;
+
+        // the leftmost action that applies to a thread determines what
+        // that thread does, threads without an action remain halted
+        vector<char> actions(m_targets.size(), 0);
+        for (const string& action : split(command + strlen("vCont;"), ';')) {
+            if (action.empty())
+                return ERR_COMMAND;
+
+            char op = action[0];
+            if (!strchr("cCsSt", op))
+                return ERR_COMMAND;
+
+            if (op == 'C' || op == 'S')
+                op = tolower(op); // signals are not forwarded to targets
+
+            size_t pos = action.find(':');
+            i64 tid = pos == string::npos ? -1 :
+                      strtoll(action.c_str() + pos + 1, nullptr, 16);
+
+            for (size_t i = 0; i < m_targets.size(); i++) {
+                if (actions[i] == 0 && (tid <= 0 || tid == (i64)(i + 1)))
+                    actions[i] = op;
+            }
+        }
+
+        if (m_nonstop) {
+            for (size_t i = 0; i < m_targets.size(); i++) {
+                target* tgt = m_targets[i];
+                switch (actions[i]) {
+                case 's':
+                    tgt->request_singlestep(this);
+                    tgt->request_resume();
+                    break;
+
+                case 'c':
+                    tgt->request_resume();
+                    break;
+
+                case 't':
+                    if (!tgt->is_halted()) {
+                        tgt->request_halt();
+                        queue_stop(stop_reply(*tgt, 0));
+                    }
+                    break;
+
+                default:
+                    break;
+                }
+            }
+
+            return "OK";
+        }
+
+        gdb_status status = GDB_STOPPED;
+        for (size_t i = 0; i < m_targets.size(); i++) {
+            target* tgt = m_targets[i];
+            switch (actions[i]) {
+            case 's':
+                tgt->request_singlestep(this);
+                tgt->request_resume();
+                m_stopped = tgt;
+                status = GDB_STEPPING;
+                break;
+
+            case 'c':
+                tgt->request_resume();
+                if (status == GDB_STOPPED)
+                    status = GDB_RUNNING;
+                break;
+
+            default:
+                tgt->request_halt();
+                break;
+            }
+        }
+
+        if (status == GDB_STOPPED)
+            return stop_reply(*m_stopped, GDBSIG_TRAP);
+
+        if (status == GDB_RUNNING)
+            m_stopped = m_ctarget ? m_ctarget : m_gtarget;
+
+        return run_until_stop(status);
+    }
+
+    string gdbserver::handle_vstopped(const char* command) {
+        lock_guard<mutex> lock(m_stop_mtx);
+        if (!m_stops.empty())
+            m_stops.pop(); // acknowledges the previously reported stop
+
+        if (m_stops.empty()) {
+            m_notified = false;
+            return "OK";
+        }
+
+        return m_stops.front();
     }
 
     gdbserver::gdbserver(u16 port, target& stub, gdb_status status):
+        gdbserver(port, vector<target*>({ &stub }), status) {
+    }
+
+    gdbserver::gdbserver(u16 port, const vector<target*>& targets,
+                         gdb_status status):
         rspserver(port),
         subscriber(),
         suspender(mkstr("gdbserver_%hu", port)),
-        m_target(stub),
-        m_target_arch(gdbarch::lookup(m_target.arch())),
+        m_targets(targets),
+        m_gtarget(nullptr),
+        m_ctarget(nullptr),
+        m_stopped(nullptr),
+        m_target_arch(nullptr),
         m_target_xml(),
         m_status(status),
         m_default(status),
+        m_nonstop(false),
+        m_status_mtx(),
+        m_status_cv(),
+        m_signal(0),
+        m_stop_mtx(),
+        m_stops(),
+        m_notified(false),
         m_cpuregs(),
         m_allregs(),
         m_handler() {
-        if (m_target_arch == nullptr)
-            VCML_ERROR("architecture %s not supported", m_target.arch());
+        if (m_targets.empty())
+            VCML_ERROR("gdbserver requires at least one target");
 
-        if (!m_target_arch->collect_core_regs(m_target, m_cpuregs))
-            VCML_ERROR("target does not support %s", m_target.arch());
+        m_gtarget = m_stopped = m_targets.front();
+        m_target_arch = gdbarch::lookup(m_gtarget->arch());
+        if (m_target_arch == nullptr)
+            VCML_ERROR("architecture %s not supported", m_gtarget->arch());
 
-        log_debug("gdb architecture %s is supported", m_target.arch());
+        for (target* tgt : m_targets) {
+            if (gdbarch::lookup(tgt->arch()) != m_target_arch) {
+                VCML_ERROR("target %s uses architecture %s, expected %s",
+                           tgt->target_name(), tgt->arch(),
+                           m_gtarget->arch());
+            }
 
-        for (const auto& feature : m_target_arch->features) {
-            vector<const cpureg*> cpuregs;
-            if (feature.collect_regs(m_target, cpuregs)) {
-                log_debug("gdb feature %s is supported", feature.name);
-                for (const cpureg* reg : cpuregs)
-                    m_allregs.insert({reg->regno, reg});
-            } else {
-                log_debug("gdb feature %s is not supported", feature.name);
+            if (!m_target_arch->collect_core_regs(*tgt, m_cpuregs[tgt]))
+                VCML_ERROR("target does not support %s", tgt->arch());
+
+            log_debug("gdb architecture %s is supported by %s",
+                      tgt->arch(), tgt->target_name());
+
+            for (const auto& feature : m_target_arch->features) {
+                vector<const cpureg*> cpuregs;
+                if (feature.collect_regs(*tgt, cpuregs)) {
+                    log_debug("gdb feature %s is supported", feature.name);
+                    for (const cpureg* reg : cpuregs)
+                        m_allregs[tgt].insert({reg->regno, reg});
+                } else {
+                    log_debug("gdb feature %s is not supported", feature.name);
+                }
             }
         }
 
         m_handler['q'] = &gdbserver::handle_query;
+        m_handler['Q'] = &gdbserver::handle_set;
 
         m_handler['s'] = &gdbserver::handle_step;
         m_handler['c'] = &gdbserver::handle_continue;
@@ -567,7 +928,8 @@ namespace vcml { namespace debugging {
         m_handler['z'] = &gdbserver::handle_breakpoint_delete;
 
         m_handler['H'] = &gdbserver::handle_thread;
-        m_handler['v'] = &gdbserver::handle_vcont;
+        m_handler['T'] = &gdbserver::handle_thread_alive;
+        m_handler['v'] = &gdbserver::handle_vcmd;
         m_handler['?'] = &gdbserver::handle_exception;
 
         if (m_status == GDB_STOPPED)
@@ -583,6 +945,26 @@ namespace vcml { namespace debugging {
     string gdbserver::handle_command(const string& command) {
         try {
             handler func = find_handler(command.c_str());
+
+            // in non-stop mode the simulation keeps running while gdb
+            // inspects halted threads, so synchronize with SystemC first;
+            // register reads of a halted thread need not stop SystemC
+            if (m_nonstop && strchr("pPgGmMXZzqv", command[0])) {
+                target* tgt = m_gtarget;
+                if (strchr("pg", command[0]) && tgt->is_halted()) {
+                    thctl_shared_guard guard(tgt->debug_resource());
+                    return (this->*func)(command.c_str());
+                }
+
+                if (strchr("PGMX", command[0])) {
+                    thctl_exclusive_guard guard(tgt->debug_resource());
+                    return (this->*func)(command.c_str());
+                }
+
+                thctl_guard guard;
+                return (this->*func)(command.c_str());
+            }
+
             return (this->*func)(command.c_str());
         } catch (report& rep) {
             vcml::logger::log(rep);
@@ -595,11 +977,19 @@ namespace vcml { namespace debugging {
 
     void gdbserver::handle_connect(const char* peer) {
         log_debug("gdb connected to %s", peer);
+        m_gtarget = m_stopped = m_targets.front();
+        m_ctarget = nullptr;
         update_status(GDB_STOPPED);
     }
 
     void gdbserver::handle_disconnect() {
         log_debug("gdb disconnected");
+        if (m_nonstop) {
+            m_nonstop = false;
+            for (target* tgt : m_targets)
+                tgt->request_resume();
+        }
+
         if (sim_running())
             update_status(m_default);
     }
@@ -28,13 +28,6 @@ namespace vcml { namespace debugging {
         return s.substr(0, pos);
     }
 
-    static inline int checksum(const char* str) {
-        int result = 0;
-        while (str && *str)
-            result += static_cast<int>(*str++);
-        return result & 0xff;
-    }
-
     static inline int char2int(char c) {
         return ((c >= 'a') && (c <= 'f')) ? c - 'a' + 10 :
                ((c >= 'A') && (c <= 'F')) ? c - 'A' + 10 :
@@ -50,16 +43,21 @@ namespace vcml { namespace debugging {
 
     rspserver::rspserver(u16 port):
         m_echo(false),
+        m_noack(false),
         m_port(),
         m_sock(port),
+        m_txbuf(),
         m_running(false),
         m_mutex(),
+        m_txmutex(),
         m_thread(),
+        m_signal_fd(-1),
         m_handlers() {
         m_port = m_sock.port();
     }
 
     rspserver::~rspserver() {
+        cancel_signal();
         if (m_thread.joinable())
             VCML_ERROR("rspserver still running");
     }
@@ -71,19 +69,36 @@ namespace vcml { namespace debugging {
         va_end(args);
     }
 
+    static void frame_packet(string& buf, char start, const string& s) {
+        buf.clear();
+        buf.reserve(2 * s.length() + 4);
+        buf += start;
+
+        int sum = 0;
+        for (char c : s) {
+            if (c == '$' || c == '#' || c == '\\') {
+                buf += '\\';
+                sum += '\\';
+            }
+
+            buf += c;
+            sum += c;
+        }
+
+        buf += '#';
+        buf += int2char((sum >> 4) & 0xf);
+        buf += int2char((sum >> 0) & 0xf);
+    }
+
     void rspserver::send_packet(const string& s) {
         VCML_ERROR_ON(!is_connected(), "no connection established");
+        lock_guard<mutex> lock(m_mutex);
 
-        string esc = escape(s, "$#");
-        int sum = checksum(esc.c_str());
-        stringstream ss;
-        ss << "$" << esc << "#"
-           << int2char((sum >> 4) & 0xf)
-           << int2char((sum >> 0) & 0xf);
+        // escape, frame and checksum in one pass into a reusable buffer
+        frame_packet(m_txbuf, '$', s);
 
         char ack;
         int attempts = 10;
-        lock_guard<mutex> lock(m_mutex);
 
         do {
             if (attempts-- == 0) {
@@ -93,9 +108,15 @@ namespace vcml { namespace debugging {
             }
 
             if (m_echo)
-                log_debug("sending packet '%s'", ss.str().c_str());
+                log_debug("sending packet '%s'", m_txbuf.c_str());
 
-            m_sock.send(ss.str());
+            {
+                lock_guard<mutex> guard(m_txmutex);
+                m_sock.send(m_txbuf);
+            }
+
+            if (m_noack)
+                return;
 
             do {
                 ack = m_sock.recv_char();
@@ -106,23 +127,37 @@ namespace vcml { namespace debugging {
         } while (ack != '+');
     }
 
+    void rspserver::send_notification(const string& s) {
+        VCML_ERROR_ON(!is_connected(), "no connection established");
+
+        // notifications are sent asynchronously and are never acknowledged
+        string buf;
+        frame_packet(buf, '%', s);
+
+        if (m_echo)
+            log_debug("sending notification '%s'", buf.c_str());
+
+        lock_guard<mutex> lock(m_txmutex);
+        m_sock.send(buf);
+    }
+
     string rspserver::recv_packet() {
         lock_guard<mutex> lock(m_mutex);
         VCML_ERROR_ON(!is_connected(), "no connection established");
         unsigned int checksum = 0;
-        stringstream ss;
+        string packet;
 
         while (true) {
             char ch = m_sock.recv_char();
             switch (ch) {
             case '$':
                 checksum = 0;
-                ss.str("");
+                packet.clear();
                 break;
 
             case '#': {
                 if (m_echo)
-                    log_debug("received packet '%s'", ss.str().c_str());
+                    log_debug("received packet '%s'", packet.c_str());
 
                 unsigned int refsum = 0;
                 refsum |= char2int(m_sock.recv_char()) << 4;
@@ -130,17 +165,21 @@ namespace vcml { namespace debugging {
 
                 if (refsum != checksum) {
                     log_debug("checksum mismatch %d != %d", refsum, checksum);
-                    m_sock.send_char('-');
+                    if (!m_noack)
+                        m_sock.send_char('-');
                     checksum = 0;
-                    ss.str("");
+                    packet.clear();
                     break;
                 }
 
+                if (m_noack)
+                    return packet;
+
                 if (m_echo)
                     log_debug("sending ack '+'");
 
                 m_sock.send_char('+');
-                return ss.str();
+                return packet;
             }
 
             case '\\':
@@ -150,7 +189,7 @@ namespace vcml { namespace debugging {
 
             default:
                 checksum = (checksum + ch) & 0xff;
-                ss << ch;
+                packet += ch;
                 break;
             }
         }
@@ -173,6 +212,36 @@ namespace vcml { namespace debugging {
         }
     }
 
+    void rspserver::notify_signal(function<void(int)> handler) {
+        cancel_signal();
+
+        if (!is_connected()) {
+            handler(-1);
+            return;
+        }
+
+        // signals are collected by the aio thread as soon as they arrive,
+        // but one might already be waiting in the socket receive buffer
+        m_signal_fd = m_sock.fd();
+        aio_notify(m_signal_fd, [this, handler](int fd) -> void {
+            int signal = recv_signal(0);
+            if (signal != 0)
+                handler(signal);
+        });
+
+        int signal = recv_signal(0);
+        if (signal != 0)
+            handler(signal);
+    }
+
+    void rspserver::cancel_signal() {
+        if (m_signal_fd < 0)
+            return;
+
+        aio_cancel(m_signal_fd);
+        m_signal_fd = -1;
+    }
+
     void rspserver::listen() {
         m_sock.listen(m_port);
         if (m_sock.accept()) {
@@ -183,6 +252,7 @@ namespace vcml { namespace debugging {
     }
 
     void rspserver::disconnect() {
+        m_noack = false;
         if (m_sock.is_connected()) {
             m_sock.disconnect();
             if (m_running)
@@ -203,6 +273,12 @@ namespace vcml { namespace debugging {
             listen();
             while (m_running && is_connected()) try {
                 string command = recv_packet();
+                if (command == "QStartNoAckMode") {
+                    send_packet("OK");
+                    m_noack = true;
+                    continue;
+                }
+
                 string response = handle_command(command);
                 if (is_connected())
                     send_packet(response);
@@ -262,6 +338,27 @@ namespace vcml { namespace debugging {
         m_handlers.erase(cmd);
     }
 
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+
+    void rspserver::hex_encode(string& s, const u8* data, size_t size) {
+        size_t pos = s.length();
+        s.resize(pos + 2 * size);
+        for (size_t i = 0; i < size; i++) {
+            s[pos++] = HEX_DIGITS[(data[i] >> 4) & 0xf];
+            s[pos++] = HEX_DIGITS[(data[i] >> 0) & 0xf];
+        }
+    }
+
+    void rspserver::hex_encode(string& s, u64 val, size_t size) {
+        size_t pos = s.length();
+        s.resize(pos + 2 * size);
+        for (size_t i = 0; i < size; i++) {
+            u8 byte = i < sizeof(val) ? (val >> (i * 8)) & 0xff : 0;
+            s[pos++] = HEX_DIGITS[(byte >> 4) & 0xf];
+            s[pos++] = HEX_DIGITS[(byte >> 0) & 0xf];
+        }
+    }
+
     const char* rspserver::ERR_COMMAND  = "E01";
     const char* rspserver::ERR_PARAM    = "E02";
     const char* rspserver::ERR_INTERNAL = "E03";
@@ -49,26 +49,58 @@ namespace vcml { namespace debugging {
         m_subscribers() {
     }
 
+    breakpoint::subscription* breakpoint::find_subscription(
+        const subscriber* s) {
+        for (subscription& sub : m_subscribers)
+            if (sub.subscr == s)
+                return &sub;
+        return nullptr;
+    }
+
     void breakpoint::notify() {
         m_count++;
 
-        for (subscriber* s : m_subscribers)
-            s->notify_breakpoint_hit(*this);
+        for (size_t i = 0; i < m_subscribers.size(); i++) {
+            subscription& sub = m_subscribers[i];
+            if (!sub.cond.is_empty() && !sub.cond.evaluate(m_target))
+                continue;
+
+            if (sub.ignore > 0) {
+                sub.ignore--;
+                continue;
+            }
+
+            sub.subscr->notify_breakpoint_hit(*this);
+        }
     }
 
     bool breakpoint::subscribe(subscriber* s) {
-        if (stl_contains(m_subscribers, s))
+        if (find_subscription(s) != nullptr)
             return false;
 
-        m_subscribers.push_back(s);
+        m_subscribers.push_back({ s, condition(), 0 });
+        return true;
+    }
+
+    bool breakpoint::subscribe(subscriber* s, const condition& cond,
+                               u64 ignore) {
+        subscription* sub = find_subscription(s);
+        if (sub == nullptr) {
+            m_subscribers.push_back({ s, cond, ignore });
+            return true;
+        }
+
+        sub->cond = cond;
+        sub->ignore = ignore;
         return true;
     }
 
     bool breakpoint::unsubscribe(subscriber* s) {
-        if (!stl_contains(m_subscribers, s))
+        subscription* sub = find_subscription(s);
+        if (sub == nullptr)
             return false;
 
-        stl_remove_erase(m_subscribers, s);
+        m_subscribers.erase(m_subscribers.begin() + (sub - &m_subscribers[0]));
         return true;
     }
 
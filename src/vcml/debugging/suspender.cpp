@@ -29,6 +29,7 @@ namespace vcml { namespace debugging {
     {
         atomic<bool> is_quitting;
         atomic<bool> is_suspended;
+        atomic<bool> has_requests;
 
         mutable mutex sysc_lock;
         condition_variable_any sysc_notify;
@@ -64,13 +65,16 @@ namespace vcml { namespace debugging {
             VCML_ERROR("cannot suspend, simulation not running");
         lock_guard<mutex> guard(suspender_lock);
         stl_add_unique(suspenders, s);
+        has_requests = true;
     }
 
     void suspend_manager::request_resume(suspender* s) {
         lock_guard<mutex> guard(suspender_lock);
         stl_remove_erase(suspenders, s);
-        if (suspenders.empty())
+        if (suspenders.empty()) {
+            has_requests = is_quitting.load();
             sysc_notify.notify_all();
+        }
     }
 
     bool suspend_manager::is_suspending(const suspender* s) const {
@@ -98,6 +102,7 @@ namespace vcml { namespace debugging {
     void suspend_manager::quit() {
         lock_guard<mutex> guard(suspender_lock);
         is_quitting = true;
+        has_requests = true;
         suspenders.clear();
         sysc_notify.notify_all();
     }
@@ -156,13 +161,14 @@ namespace vcml { namespace debugging {
     suspend_manager::suspend_manager():
         is_quitting(false),
         is_suspended(false),
+        has_requests(false),
         sysc_lock(),
         sysc_notify(),
         suspender_lock(),
         suspenders() {
         sysc_lock.lock();
         auto fn = std::bind(&suspend_manager::handle_requests, this);
-        on_each_delta_cycle(fn);
+        on_each_delta_cycle(fn, has_requests);
     }
 
     suspender::suspender(const string& name):
@@ -47,6 +47,99 @@ namespace vcml { namespace debugging {
             VCML_ERROR("failed to read cpureg %s", name.c_str());
     }
 
+    u64 target::wpindex::page_bit(u64 page) {
+        return (page * 0x9e3779b97f4a7c15ull) >> 52; // 4096 filter bits
+    }
+
+    bool target::wpindex::is_filtered(const range& addr) const {
+        u64 first = addr.start >> PAGE_BITS;
+        u64 last = addr.end >> PAGE_BITS;
+        for (u64 page = first; page <= last; page++) {
+            u64 bit = page_bit(page);
+            if (filter[bit / 64] & (1ull << (bit % 64)))
+                return false;
+        }
+
+        return true;
+    }
+
+    void target::wpindex::build(const vector<watchpoint*>& all,
+                                vcml_access prot) {
+        wps.clear();
+        ends.clear();
+        filter.fill(0);
+
+        for (watchpoint* wp : all) {
+            if (is_read_allowed(prot) && wp->has_read_subscribers())
+                wps.push_back(wp);
+            else if (is_write_allowed(prot) && wp->has_write_subscribers())
+                wps.push_back(wp);
+        }
+
+        std::sort(wps.begin(), wps.end(), [](watchpoint* a, watchpoint* b) {
+            return a->address().start < b->address().start;
+        });
+
+        u64 maxend = 0;
+        for (watchpoint* wp : wps) {
+            const range& addr = wp->address();
+            maxend = max(maxend, addr.end);
+            ends.push_back(maxend);
+
+            u64 first = addr.start >> PAGE_BITS;
+            u64 last = addr.end >> PAGE_BITS;
+            if (last - first >= FILTER_BITS) {
+                filter.fill(~0ull);
+                continue;
+            }
+
+            for (u64 page = first; page <= last; page++) {
+                u64 bit = page_bit(page);
+                filter[bit / 64] |= 1ull << (bit % 64);
+            }
+        }
+    }
+
+    template <typename FUNC>
+    void target::wpindex::lookup(const range& addr, FUNC func) const {
+        if (wps.empty() || is_filtered(addr))
+            return;
+
+        // find the last watchpoint starting at or before the end of the
+        // access, then walk back while running end addresses still reach
+        auto it = std::upper_bound(wps.begin(), wps.end(), addr.end,
+            [](u64 end, const watchpoint* wp) -> bool {
+                return end < wp->address().start;
+        });
+
+        for (size_t i = it - wps.begin(); i > 0 && ends[i - 1] >= addr.start;
+             i--) {
+            if (wps[i - 1]->address().overlaps(addr))
+                func(wps[i - 1]);
+        }
+    }
+
+    void target::update_breakpoints() {
+        size_t size = 16;
+        while (size < 2 * m_breakpoints.size())
+            size *= 2;
+
+        m_bptable.assign(size, { 0, nullptr });
+        m_bpshift = 64 - ctz((u64)size);
+
+        for (breakpoint* bp : m_breakpoints) {
+            size_t idx = (bp->address() * 0x9e3779b97f4a7c15ull) >> m_bpshift;
+            while (m_bptable[idx].bp != nullptr)
+                idx = (idx + 1) & (size - 1);
+            m_bptable[idx] = { bp->address(), bp };
+        }
+    }
+
+    void target::update_watchpoints() {
+        m_wpindex_r.build(m_watchpoints, VCML_ACCESS_READ);
+        m_wpindex_w.build(m_watchpoints, VCML_ACCESS_WRITE);
+    }
+
     unordered_map<string, target*> target::s_targets;
 
     void target::define_cpuregs(const vector<cpureg>& regs) {
@@ -70,8 +163,14 @@ namespace vcml { namespace debugging {
         m_cpuregs(),
         m_symbols(),
         m_steppers(),
+        m_halted(false),
+        m_dbgres(true),
         m_breakpoints(),
-        m_watchpoints() {
+        m_watchpoints(),
+        m_bptable(),
+        m_bpshift(),
+        m_wpindex_r(),
+        m_wpindex_w() {
         module* host = hierarchy_search<module>();
         VCML_ERROR_ON(!host, "debug target declared outside module");
         m_name = host->name();
@@ -79,6 +178,9 @@ namespace vcml { namespace debugging {
         if (stl_contains(s_targets, m_name))
             VCML_ERROR("debug target '%s' already exists", m_name.c_str());
         s_targets[m_name] = this;
+
+        update_breakpoints();
+        update_watchpoints();
     }
 
     target::~target() {
@@ -295,44 +397,48 @@ namespace vcml { namespace debugging {
     }
 
     void target::notify_breakpoint_hit(u64 pc) {
-        for (auto& bp : m_breakpoints)
-            if (bp->address() == pc)
-                bp->notify();
+        breakpoint* bp = find_breakpoint(pc);
+        if (bp != nullptr)
+            bp->notify();
     }
 
     void target::notify_watchpoint_read(const range& addr) {
-        for (auto& wp : m_watchpoints)
-            if (wp->address().overlaps(addr))
-                wp->notify_read(addr);
+        m_wpindex_r.lookup(addr, [&addr](watchpoint* wp) -> void {
+            wp->notify_read(addr);
+        });
     }
 
     void target::notify_watchpoint_write(const range& addr, u64 newval) {
-        for (auto& wp : m_watchpoints)
-            if (wp->address().overlaps(addr))
-                wp->notify_write(addr, newval);
+        m_wpindex_w.lookup(addr, [&addr, newval](watchpoint* wp) -> void {
+            wp->notify_write(addr, newval);
+        });
     }
 
     const breakpoint* target::lookup_breakpoint(u64 addr) {
-        for (auto& bp : m_breakpoints)
-            if (bp->address() == addr)
-                return bp;
-        return nullptr;
+        return find_breakpoint(addr);
     }
 
     const breakpoint* target::insert_breakpoint(u64 addr, subscriber* subscr) {
-        for (auto& bp : m_breakpoints)
-            if (bp->address() == addr) {
-                bp->subscribe(subscr);
-                return bp;
-            }
+        return insert_breakpoint(addr, subscr, condition());
+    }
+
+    const breakpoint* target::insert_breakpoint(u64 addr, subscriber* subscr,
+                                                const condition& cond,
+                                                u64 ignore) {
+        breakpoint* bp = find_breakpoint(addr);
+        if (bp != nullptr) {
+            bp->subscribe(subscr, cond, ignore);
+            return bp;
+        }
 
         if (!insert_breakpoint(addr))
             return nullptr;
 
         const symbol* func = m_symbols.find_function(addr);
         breakpoint* newbp = new breakpoint(*this, addr, func);
-        newbp->subscribe(subscr);
+        newbp->subscribe(subscr, cond, ignore);
         m_breakpoints.push_back(newbp);
+        update_breakpoints();
         return newbp;
     }
 
@@ -355,6 +461,7 @@ namespace vcml { namespace debugging {
 
         delete *it;
         m_breakpoints.erase(it);
+        update_breakpoints();
         return true;
     }
 
@@ -375,6 +482,7 @@ namespace vcml { namespace debugging {
 
         delete *it;
         m_breakpoints.erase(it);
+        update_breakpoints();
 
         return remove_breakpoint(addr);
     }
@@ -407,6 +515,7 @@ namespace vcml { namespace debugging {
             (*wp)->subscribe(VCML_ACCESS_WRITE, subscr);
         }
 
+        update_watchpoints();
         return true;
     }
 
@@ -439,6 +548,7 @@ namespace vcml { namespace debugging {
             m_watchpoints.erase(wp);
         }
 
+        update_watchpoints();
         return true;
     }
 
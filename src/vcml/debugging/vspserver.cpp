@@ -313,7 +313,25 @@ namespace vcml { namespace debugging {
             addr = sym->virt_addr();
         }
 
-        const breakpoint* bp = tgt->insert_breakpoint(addr, this);
+        // optional arguments: cond=<expression> and ignore=<count>
+        condition cond;
+        u64 ignore = 0;
+        for (size_t i = 3; i < args.size(); i++) {
+            size_t pos = args[i].find('=');
+            string key = args[i].substr(0, pos);
+            string val = pos == string::npos ? "" : args[i].substr(pos + 1);
+
+            if (key == "cond") {
+                if (!cond.add_expression(val, *tgt))
+                    return mkstr("E,invalid condition: %s", val.c_str());
+            } else if (key == "ignore" && is_number(val)) {
+                ignore = from_string<u64>(val);
+            } else {
+                return mkstr("E,invalid argument: %s", args[i].c_str());
+            }
+        }
+
+        const breakpoint* bp = tgt->insert_breakpoint(addr, this, cond, ignore);
         if (bp == nullptr)
             return mkstr("E,failed to insert breakpoint at 0x%lx", addr);
 
@@ -0,0 +1,178 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "vcml/logging/log_async.h"
+
+namespace vcml {
+
+    mutex log_async::s_mtx;
+    vector<log_async*> log_async::s_loggers;
+
+    void log_async::report_drops(const logmsg& next, u64 dropped) {
+        logmsg msg(next);
+        msg.level = LOG_WARN;
+        msg.sender = "log";
+        msg.source = { "", -1 };
+        msg.lines = { mkstr("%lu log messages dropped", dropped) };
+        m_logger->write_log(msg);
+    }
+
+    void log_async::writer() {
+        deque<logmsg> batch;
+        std::unique_lock<mutex> lock(m_mtx);
+
+        while (true) {
+            m_cv_data.wait(lock, [&]() -> bool {
+                return !m_queue.empty() || !m_running;
+            });
+
+            if (m_queue.empty() && !m_running)
+                break;
+
+            u64 dropped = m_dropped - m_reported;
+            m_reported = m_dropped;
+
+            batch.swap(m_queue);
+            m_busy = true;
+            m_cv_space.notify_all();
+            lock.unlock();
+
+            if (dropped > 0)
+                report_drops(batch.front(), dropped);
+
+            for (const logmsg& msg : batch)
+                if (m_logger->check_filters(msg))
+                    m_logger->write_log(msg);
+            batch.clear();
+
+            lock.lock();
+            m_busy = false;
+            m_cv_done.notify_all();
+        }
+    }
+
+    u64 log_async::dropped() {
+        lock_guard<mutex> guard(m_mtx);
+        return m_dropped;
+    }
+
+    log_async::log_async(logger* wrapped, size_t capacity,
+                         log_overflow policy):
+        logger(wrapped->m_min, wrapped->m_max),
+        m_logger(wrapped),
+        m_capacity(capacity),
+        m_policy(policy),
+        m_mtx(),
+        m_cv_data(),
+        m_cv_space(),
+        m_cv_done(),
+        m_queue(),
+        m_busy(false),
+        m_running(true),
+        m_dropped(0),
+        m_reported(0),
+        m_writer() {
+        VCML_ERROR_ON(m_logger == nullptr, "no logger to wrap");
+        VCML_ERROR_ON(m_capacity == 0, "log queue capacity cannot be zero");
+
+        m_logger->unregister_logger();
+        m_writer = thread(&log_async::writer, this);
+        set_thread_name(m_writer, "vcml_log");
+
+        lock_guard<mutex> guard(s_mtx);
+        s_loggers.push_back(this);
+
+        static bool hooked = false;
+        if (!hooked) {
+            on_end_of_simulation(&log_async::flush_all);
+            hooked = true;
+        }
+    }
+
+    log_async::~log_async() {
+        {
+            lock_guard<mutex> guard(s_mtx);
+            stl_remove_erase(s_loggers, this);
+        }
+
+        {
+            lock_guard<mutex> guard(m_mtx);
+            m_running = false;
+            m_cv_data.notify_all();
+            m_cv_space.notify_all();
+        }
+
+        if (m_writer.joinable())
+            m_writer.join();
+
+        delete m_logger;
+    }
+
+    void log_async::write_log(const logmsg& msg) {
+        {
+            // errors are never dropped, they wait for room instead
+            log_overflow policy = m_policy;
+            if (msg.level == LOG_ERROR)
+                policy = LOG_OVERFLOW_BLOCK;
+
+            std::unique_lock<mutex> lock(m_mtx);
+            if (m_queue.size() >= m_capacity) {
+                switch (policy) {
+                case LOG_OVERFLOW_BLOCK:
+                    m_cv_space.wait(lock, [&]() -> bool {
+                        return m_queue.size() < m_capacity || !m_running;
+                    });
+                    break;
+
+                case LOG_OVERFLOW_DROP_OLDEST:
+                    m_queue.pop_front();
+                    m_dropped++;
+                    break;
+
+                case LOG_OVERFLOW_COUNT_DROPS:
+                default:
+                    m_dropped++;
+                    return;
+                }
+            }
+
+            m_queue.push_back(msg);
+            m_cv_data.notify_one();
+        }
+
+        // errors usually precede an abort, so do not return before they
+        // actually made it into the output
+        if (msg.level == LOG_ERROR)
+            flush();
+    }
+
+    void log_async::flush() {
+        std::unique_lock<mutex> lock(m_mtx);
+        m_cv_data.notify_one();
+        m_cv_done.wait(lock, [&]() -> bool {
+            return (m_queue.empty() && !m_busy) || !m_running;
+        });
+    }
+
+    void log_async::flush_all() {
+        lock_guard<mutex> guard(s_mtx);
+        for (log_async* logger : s_loggers)
+            logger->flush();
+    }
+
+}
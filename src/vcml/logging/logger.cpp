@@ -22,6 +22,8 @@
 namespace vcml {
 
     vector<logger*> logger::loggers[NUM_LOG_LEVELS];
+    atomic<bool> logger::listening[NUM_LOG_LEVELS];
+    mutex logger::registry_mtx;
 
     bool logger::print_time_stamp = true;
     bool logger::print_delta_cycle = false;
@@ -86,13 +88,19 @@ namespace vcml {
     }
 
     void logger::register_logger() {
-        for (int l = m_min; l <= m_max; l++)
+        lock_guard<mutex> guard(registry_mtx);
+        for (int l = m_min; l <= m_max; l++) {
             stl_add_unique(logger::loggers[l], this);
+            listening[l] = true;
+        }
     }
 
     void logger::unregister_logger() {
-        for (int l = m_min; l <= m_max; l++)
+        lock_guard<mutex> guard(registry_mtx);
+        for (int l = m_min; l <= m_max; l++) {
             stl_remove_erase(logger::loggers[l], this);
+            listening[l] = !logger::loggers[l].empty();
+        }
     }
 
     bool logger::check_filters(const logmsg& msg) const {
@@ -168,6 +176,24 @@ namespace vcml {
         print_source = print;
     }
 
+    string logger::trace_prefix(trace_direction direction) {
+        stringstream ss;
+        if (direction == TRACE_FW)
+            trace_curr_indent += trace_indent_incr;
+        if (direction >= TRACE_FW)
+            ss << string(trace_curr_indent, ' ') << ">> ";
+        if (direction <= TRACE_BW)
+            ss << string(trace_curr_indent, ' ') << "<< ";
+        if (direction == TRACE_BW) {
+            if (trace_curr_indent >= trace_indent_incr)
+                trace_curr_indent -= trace_indent_incr;
+            else
+                trace_curr_indent = 0;
+        }
+
+        return ss.str();
+    }
+
     void logger::print_prefix(ostream& os, const logmsg& msg) {
         os << "[" << vcml::logger::prefix[msg.level];
 
@@ -217,5 +243,13 @@ namespace vcml {
         }
     }
 
-}
+#ifndef VCML_OMIT_LOGGING_SOURCE
+    void log_publish(log_level lvl, const char* file, int line,
+                     const char* fmt, ...) {
+        va_list args; va_start(args, fmt);
+        logger::publish(lvl, call_origin(), vmkstr(fmt, args), file, line);
+        va_end(args);
+    }
+#endif
 
+}
@@ -0,0 +1,272 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+#include "vcml/logging/trace_bin.h"
+#include "vcml/protocols/tlm_sbi.h"
+
+namespace vcml {
+
+    static atomic<u64> g_next_gen(1);
+
+    // the ring of the current thread is cached together with the generation
+    // of the tracer it belongs to, so stale rings of deleted tracers are not
+    // used by accident
+    static thread_local u64 t_gen = 0;
+    static thread_local void* t_ring = nullptr;
+
+    static u8 trace_flags(const tlm_sbi& sbi) {
+        u8 flags = 0;
+        if (sbi.is_debug)
+            flags |= TRACE_FLAG_DEBUG;
+        if (sbi.is_nodmi)
+            flags |= TRACE_FLAG_NODMI;
+        if (sbi.is_sync)
+            flags |= TRACE_FLAG_SYNC;
+        if (sbi.is_insn)
+            flags |= TRACE_FLAG_INSN;
+        if (sbi.is_excl)
+            flags |= TRACE_FLAG_EXCL;
+        if (sbi.is_lock)
+            flags |= TRACE_FLAG_LOCK;
+        return flags;
+    }
+
+    trace_bin::ring::ring():
+        records(RING_SIZE),
+        head(0),
+        tail(0),
+        ids(),
+        pending() {
+        pending.reserve(MAX_INFLIGHT);
+    }
+
+    trace_bin::ring* trace_bin::local_ring() {
+        if (t_gen == m_gen)
+            return (ring*)t_ring;
+
+        ring* r = new ring();
+
+        lock_guard<mutex> guard(m_mtx);
+        m_rings.push_back(r);
+
+        t_gen = m_gen;
+        t_ring = r;
+        return r;
+    }
+
+    u32 trace_bin::socket_id(ring* r, const void* sender, const char* name) {
+        auto it = r->ids.find(sender);
+        if (it != r->ids.end())
+            return it->second;
+
+        u32 id;
+
+        {
+            lock_guard<mutex> guard(m_mtx);
+            auto jt = m_ids.find(name);
+            if (jt != m_ids.end()) {
+                id = jt->second;
+            } else {
+                id = m_ids.size();
+                m_ids[name] = id;
+            }
+        }
+
+        r->ids[sender] = id;
+
+        // every thread defines the names it uses in its own ring, so that
+        // definitions always precede their first use in the file
+        size_t len = strlen(name);
+        size_t off = 0;
+        do {
+            trace_record& rec = claim(r);
+            memset(&rec, 0, sizeof(rec));
+            rec.kind = off ? TRACE_RECORD_NAME_CONT : TRACE_RECORD_NAME;
+            rec.socket = id;
+            size_t n = min(len - off, sizeof(rec.name));
+            memcpy(rec.name, name + off, n);
+            commit(r);
+            off += n;
+        } while (off < len);
+
+        return id;
+    }
+
+    trace_record& trace_bin::claim(ring* r) {
+        u64 head = r->head.load(std::memory_order_relaxed);
+        while (head - r->tail.load(std::memory_order_acquire) >= RING_SIZE) {
+            m_wait_cv.notify_one();
+            std::this_thread::yield();
+        }
+
+        return r->records[head % RING_SIZE];
+    }
+
+    void trace_bin::commit(ring* r) {
+        u64 head = r->head.load(std::memory_order_relaxed) + 1;
+        r->head.store(head, std::memory_order_release);
+
+        u64 used = head - r->tail.load(std::memory_order_relaxed);
+        if (used == RING_SIZE / 2)
+            m_wait_cv.notify_one();
+    }
+
+    void trace_bin::drain() {
+        lock_guard<mutex> drain_guard(m_drain_mtx);
+
+        vector<ring*> rings;
+
+        {
+            lock_guard<mutex> guard(m_mtx);
+            rings = m_rings;
+        }
+
+        for (ring* r : rings) {
+            u64 tail = r->tail.load(std::memory_order_relaxed);
+            u64 head = r->head.load(std::memory_order_acquire);
+
+            while (tail < head) {
+                size_t idx = tail % RING_SIZE;
+                size_t num = min<u64>(head - tail, RING_SIZE - idx);
+                size_t n = fwrite(&r->records[idx], sizeof(trace_record),
+                                  num, m_file);
+                if (n != num)
+                    log_warn("failed to write trace file %s", path());
+
+                tail += num;
+                m_records += num;
+            }
+
+            r->tail.store(tail, std::memory_order_release);
+        }
+    }
+
+    void trace_bin::writer() {
+        while (m_running) {
+            drain();
+
+            std::unique_lock<mutex> lock(m_wait_mtx);
+            m_wait_cv.wait_for(lock, std::chrono::milliseconds(10));
+        }
+
+        drain();
+    }
+
+    trace_bin* trace_bin::s_active = nullptr;
+
+    trace_bin::trace_bin(const string& path):
+        m_path(path),
+        m_file(fopen(path.c_str(), "wb")),
+        m_gen(g_next_gen++),
+        m_mtx(),
+        m_rings(),
+        m_ids(),
+        m_drain_mtx(),
+        m_wait_mtx(),
+        m_wait_cv(),
+        m_running(true),
+        m_records(0),
+        m_writer() {
+        VCML_ERROR_ON(!m_file, "cannot open trace file %s", path.c_str());
+        VCML_ERROR_ON(s_active, "binary tracer already active: %s",
+                      s_active->path());
+
+        trace_file_header header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, TRACE_FORMAT_MAGIC, sizeof(header.magic));
+        header.version = TRACE_FORMAT_VERSION;
+        header.record_size = sizeof(trace_record);
+        sc_time resolution = sc_core::sc_get_time_resolution();
+        header.resolution = (u64)(resolution.to_seconds() * 1e15 + 0.5);
+
+        if (fwrite(&header, sizeof(header), 1, m_file) != 1)
+            VCML_ERROR("failed to write trace file %s", path.c_str());
+
+        m_writer = thread(std::bind(&trace_bin::writer, this));
+        set_thread_name(m_writer, "trace_bin");
+
+        s_active = this;
+    }
+
+    trace_bin::~trace_bin() {
+        if (s_active == this)
+            s_active = nullptr;
+
+        m_running = false;
+        m_wait_cv.notify_all();
+        if (m_writer.joinable())
+            m_writer.join();
+
+        fclose(m_file);
+
+        for (ring* r : m_rings)
+            delete r;
+    }
+
+    void trace_bin::flush() {
+        drain();
+        fflush(m_file);
+    }
+
+    void trace_bin::record(trace_direction dir, const void* sender,
+                           const char* name, const tlm_generic_payload& tx,
+                           const sc_time& dt) {
+        ring* r = local_ring();
+        u32 id = socket_id(r, sender, name);
+        u64 now = (sc_time_stamp() + dt).value();
+        u64 latency = 0;
+
+        if (dir >= TRACE_FW) {
+            if (r->pending.size() >= MAX_INFLIGHT)
+                r->pending.erase(r->pending.begin());
+            r->pending.push_back({ &tx, id, now });
+        } else {
+            for (size_t i = r->pending.size(); i > 0; i--) {
+                const inflight& fw = r->pending[i - 1];
+                if (fw.tx == &tx && fw.socket == id) {
+                    latency = now - fw.time;
+                    r->pending.erase(r->pending.begin() + i - 1);
+                    break;
+                }
+            }
+        }
+
+        trace_record& rec = claim(r);
+        rec.kind = dir >= TRACE_FW ? TRACE_RECORD_FW : TRACE_RECORD_BW;
+        rec.command = (u8)tx.get_command();
+        rec.response = (i8)tx.get_response_status();
+        rec.flags = trace_flags(tx_get_sbi(tx));
+        if (dir == TRACE_FW_NOINDENT || dir == TRACE_BW_NOINDENT)
+            rec.flags |= TRACE_FLAG_NOINDENT;
+        rec.socket = id;
+        rec.time = now;
+        rec.delta = sc_delta_count();
+        rec.addr = tx.get_address();
+        rec.size = tx.get_data_length();
+        rec.cpuid = tx_get_sbi(tx).cpuid;
+        rec.latency = latency;
+
+        size_t n = min<size_t>(rec.size, sizeof(rec.data));
+        if (tx.get_data_ptr() != nullptr)
+            memcpy(rec.data, tx.get_data_ptr(), n);
+        if (n < sizeof(rec.data))
+            memset(rec.data + n, 0, sizeof(rec.data) - n);
+
+        commit(r);
+    }
+
+}
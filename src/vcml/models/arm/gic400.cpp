@@ -390,6 +390,36 @@ namespace vcml { namespace arm {
         return ICFGR_SPI;
     }
 
+    u8 gic400::distif::write_IPRIORITY_SGI(u8 value, size_t idx) {
+        IPRIORITY_SGI[idx] = value;
+
+        int cpu = current_cpu();
+        if (cpu >= 0 && cpu < (int)NCPU)
+            m_parent->refresh_irq(idx, 1 << cpu);
+        return value;
+    }
+
+    u8 gic400::distif::write_IPRIORITY_PPI(u8 value, size_t idx) {
+        IPRIORITY_PPI[idx] = value;
+
+        int cpu = current_cpu();
+        if (cpu >= 0 && cpu < (int)NCPU)
+            m_parent->refresh_irq(NSGI + idx, 1 << cpu);
+        return value;
+    }
+
+    u8 gic400::distif::write_IPRIORITY_SPI(u8 value, size_t idx) {
+        IPRIORITY_SPI[idx] = value;
+        m_parent->refresh_irq(NPRIV + idx, gic400::ALL_CPU);
+        return value;
+    }
+
+    u8 gic400::distif::write_ITARGETS_SPI(u8 value, size_t idx) {
+        ITARGETS_SPI[idx] = value;
+        m_parent->refresh_irq(NPRIV + idx, gic400::ALL_CPU);
+        return value;
+    }
+
     u32 gic400::distif::write_SGIR(u32 value) {
         int cpu = current_cpu();
         if (cpu < 0) {
@@ -419,16 +449,21 @@ namespace vcml { namespace arm {
             break;
         }
 
-        m_parent->set_irq_pending(sgi_num, true, targets);
-        for (unsigned int target = 0; target < NCPU; target++) {
-            if (targets & (1 << target))
-                set_sgi_pending(1 << cpu, sgi_num, target, true);
-        }
+        send_sgi(sgi_num, cpu, targets);
+        return SGIR;
+    }
 
-        m_parent->set_irq_signaled(sgi_num, false, targets);
-        m_parent->update();
+    void gic400::distif::send_sgi(unsigned int sgi, unsigned int src_cpu,
+                                  unsigned int targets) {
+        targets &= gic400::ALL_CPU;
 
-        return SGIR;
+        m_parent->set_irq_pending(sgi, true, targets);
+        for (unsigned int mask = targets; mask != 0; mask &= mask - 1)
+            set_sgi_pending(1 << src_cpu, sgi, ctz(mask), true);
+
+        // only the target cpus can observe a change
+        m_parent->set_irq_signaled(sgi, false, targets);
+        m_parent->update_cpus(targets);
     }
 
 
@@ -445,7 +480,7 @@ namespace vcml { namespace arm {
         set_sgi_pending(value, irq, cpu, true);
         m_parent->set_irq_pending(irq, true, mask);
         m_parent->set_irq_signaled(irq, false, mask);
-        m_parent->update();
+        m_parent->update_cpus(mask);
 
         return SPENDSGIR;
     }
@@ -463,7 +498,7 @@ namespace vcml { namespace arm {
         set_sgi_pending(value, irq, cpu, false);
         if (CPENDSGIR.bank(cpu, idx) == 0) // clear SGI if no sources remain
             m_parent->set_irq_pending(irq, false, mask);
-        m_parent->update();
+        m_parent->update_cpus(mask);
         return CPENDSGIR;
     }
 
@@ -576,13 +611,16 @@ namespace vcml { namespace arm {
         IPRIORITY_SGI.set_banked();
         IPRIORITY_SGI.sync_never();
         IPRIORITY_SGI.allow_read_write();
+        IPRIORITY_SGI.on_write(&distif::write_IPRIORITY_SGI);
 
         IPRIORITY_PPI.set_banked();
         IPRIORITY_PPI.sync_never();
         IPRIORITY_PPI.allow_read_write();
+        IPRIORITY_PPI.on_write(&distif::write_IPRIORITY_PPI);
 
-        IPRIORITY_SGI.sync_never();
-        IPRIORITY_SGI.allow_read_write();
+        IPRIORITY_SPI.sync_never();
+        IPRIORITY_SPI.allow_read_write();
+        IPRIORITY_SPI.on_write(&distif::write_IPRIORITY_SPI);
 
         ITARGETS_PPI.set_banked();
         ITARGETS_PPI.sync_always();
@@ -591,6 +629,7 @@ namespace vcml { namespace arm {
 
         ITARGETS_SPI.sync_always();
         ITARGETS_SPI.allow_read_write();
+        ITARGETS_SPI.on_write(&distif::write_ITARGETS_SPI);
 
         ICFGR_SGI.allow_read_only();
         ICFGR_SGI.sync_on_read();
@@ -633,6 +672,10 @@ namespace vcml { namespace arm {
 
         for (unsigned int i = 0; i < CIDR.count(); i++)
             CIDR[i] = (PCID >> (i * 8)) & 0xFF;
+
+        // priorities and targets were reset behind the arbiter's back
+        if (sim_running())
+            m_parent->refresh_all_irqs();
     }
 
     void gic400::distif::setup(unsigned int num_cpu, unsigned int num_irq) {
@@ -1151,7 +1194,12 @@ namespace vcml { namespace arm {
         VIRQ_OUT("VIRQ_OUT"),
         m_irq_num(NPRIV),
         m_cpu_num(0),
-        m_irq_state() {
+        m_irq_state(),
+        m_eligible(),
+        m_eligible_prio(),
+        m_prio_irqs(),
+        m_prio_words(),
+        m_prio_used() {
         DISTIF.CLOCK.bind(CLOCK);
         DISTIF.RESET.bind(RESET);
         CPUIF.CLOCK.bind(CLOCK);
@@ -1167,107 +1215,154 @@ namespace vcml { namespace arm {
     }
 
     void gic400::update(bool virt) {
-        for (unsigned int cpu = 0; cpu < m_cpu_num; cpu++) {
-            unsigned int irq;
-            unsigned int mask = 1 << cpu;
-            unsigned int best_irq = SPURIOUS_IRQ;
-            unsigned int best_prio = IDLE_PRIO;
-
-            if (!virt)
-                CPUIF.HPPIR.bank(cpu) = SPURIOUS_IRQ;
-            else
-                VCPUIF.HPPIR.bank(cpu) = SPURIOUS_IRQ;
-
-            if (!virt && (DISTIF.CTLR == 0u || CPUIF.CTLR.bank(cpu) == 0u)) {
-                log_debug("Disabling IRQ[%d]", cpu);
-                IRQ_OUT[cpu].write(false);
-                continue; // TODO check if continue or return
-            }
+        for (unsigned int cpu = 0; cpu < m_cpu_num; cpu++)
+            update_cpu(cpu, virt);
+    }
 
-            if (virt && (VIFCTRL.HCR.bank(cpu) == 0u)) {
-                log_debug("Disabling VIRQ[%d]", cpu);
-                VIRQ_OUT[cpu].write(false);
-                continue;
-            }
+    void gic400::update_cpus(unsigned int mask, bool virt) {
+        for (mask &= (1u << m_cpu_num) - 1; mask != 0; mask &= mask - 1)
+            update_cpu(ctz(mask), virt);
+    }
 
-            if (!virt) {
-                // check SGIs
-                for (irq = 0; irq < NSGI; irq++) {
-                    if (is_irq_enabled(irq, mask) && test_pending(irq, mask) &&
-                        !is_irq_active(irq, mask)) {
-                        if (DISTIF.IPRIORITY_SGI.bank(cpu, irq) < best_prio) {
-                            best_prio = DISTIF.IPRIORITY_SGI.bank(cpu, irq);
-                            best_irq = irq;
-                        }
-                    }
-                }
+    void gic400::update_cpu(unsigned int cpu, bool virt) {
+        unsigned int best_irq = SPURIOUS_IRQ;
+        unsigned int best_prio = IDLE_PRIO;
 
-                // check PPIs
-                for (irq = NSGI; irq < NPRIV; irq++) {
-                    if (is_irq_enabled(irq, mask) && test_pending(irq, mask) &&
-                        !is_irq_active(irq, mask)) {
-                        int idx = irq - NSGI;
-                        if (DISTIF.IPRIORITY_PPI.bank(cpu, idx) < best_prio) {
-                            best_prio = DISTIF.IPRIORITY_PPI.bank(cpu, idx);
-                            best_irq = irq;
-                        }
-                    }
-                }
+        if (!virt)
+            CPUIF.HPPIR.bank(cpu) = SPURIOUS_IRQ;
+        else
+            VCPUIF.HPPIR.bank(cpu) = SPURIOUS_IRQ;
 
-                // check SPIs
-                for (irq = NPRIV; irq < m_irq_num; irq++) {
-                    int idx = irq - NPRIV;
-                    if (is_irq_enabled(irq, mask) && test_pending(irq, mask) &&
-                        (DISTIF.ITARGETS_SPI[idx] & mask) && !is_irq_active(irq, mask)) {
-                        if (DISTIF.IPRIORITY_SPI[idx] < best_prio) {
-                            best_prio = DISTIF.IPRIORITY_SPI[idx];
-                            best_irq = irq;
-                        }
-                    }
-                }
+        if (!virt && (DISTIF.CTLR == 0u || CPUIF.CTLR.bank(cpu) == 0u)) {
+            log_debug("Disabling IRQ[%d]", cpu);
+            IRQ_OUT[cpu].write_deferred(false);
+            return;
+        }
 
-            } else {
+        if (virt && (VIFCTRL.HCR.bank(cpu) == 0u)) {
+            log_debug("Disabling VIRQ[%d]", cpu);
+            VIRQ_OUT[cpu].write_deferred(false);
+            return;
+        }
 
-                for (unsigned int lr_idx = 0; lr_idx < NLR; lr_idx++) {
-                    if (VIFCTRL.is_lr_pending(lr_idx, cpu)) {
-                        u8 prio = (VIFCTRL.LR.bank(cpu, lr_idx) & (0x1F << 23)) >> 23;
-                        if (prio < best_prio) {
-                            best_prio = prio;
-                            best_irq = (VIFCTRL.LR.bank(cpu, lr_idx) & 0x1FF);
-                        }
+        if (!virt) {
+            best_irq = highest_pending_irq(cpu, best_prio);
+        } else {
+            for (unsigned int lr_idx = 0; lr_idx < NLR; lr_idx++) {
+                if (VIFCTRL.is_lr_pending(lr_idx, cpu)) {
+                    u8 prio = (VIFCTRL.LR.bank(cpu, lr_idx) & (0x1F << 23)) >> 23;
+                    if (prio < best_prio) {
+                        best_prio = prio;
+                        best_irq = (VIFCTRL.LR.bank(cpu, lr_idx) & 0x1FF);
                     }
                 }
             }
+        }
 
-            // signal IRQ to processor if priority is higher
-            bool level = false;
-            if (!virt) {
-                if (best_prio < CPUIF.PMR.bank(cpu)) {
-                    log_debug("setting irq %u pending on cpuif %u", best_irq, cpu);
-                    CPUIF.HPPIR.bank(cpu) = best_irq;
-                    if (best_prio < CPUIF.RPR.bank(cpu))
-                        level = true;
-                }
-            } else {
-                if (best_prio < VCPUIF.PMR.bank(cpu)) {
-                    VCPUIF.HPPIR.bank(cpu) = best_irq;
-                    if (best_prio < VCPUIF.RPR.bank(cpu))
-                        level = true;
-                 }
+        // signal IRQ to processor if priority is higher
+        bool level = false;
+        if (!virt) {
+            if (best_prio < CPUIF.PMR.bank(cpu)) {
+                log_debug("setting irq %u pending on cpuif %u", best_irq, cpu);
+                CPUIF.HPPIR.bank(cpu) = best_irq;
+                if (best_prio < CPUIF.RPR.bank(cpu))
+                    level = true;
             }
+        } else {
+            if (best_prio < VCPUIF.PMR.bank(cpu)) {
+                VCPUIF.HPPIR.bank(cpu) = best_irq;
+                if (best_prio < VCPUIF.RPR.bank(cpu))
+                    level = true;
+             }
+        }
 
-            if (!virt) {
-                if (IRQ_OUT[cpu].read() != level)
-                    log_debug("%sing %s[%u] for irq %u",
-                              level ? "sett" : "clear", "IRQ", cpu, best_irq);
-                IRQ_OUT[cpu].write(level); // FIRQ or NIRQ?
-            } else {
-                if(VIRQ_OUT[cpu].read() != level)
-                    log_debug("%sing %s[%u] for irq %u",
-                              level ? "sett" : "clear", "VIRQ", cpu, best_irq);
-                VIRQ_OUT[cpu].write(level);
+        if (!virt) {
+            if (IRQ_OUT[cpu].read() != level)
+                log_debug("%sing %s[%u] for irq %u",
+                          level ? "sett" : "clear", "IRQ", cpu, best_irq);
+            IRQ_OUT[cpu].write_deferred(level); // FIRQ or NIRQ?
+        } else {
+            if(VIRQ_OUT[cpu].read() != level)
+                log_debug("%sing %s[%u] for irq %u",
+                          level ? "sett" : "clear", "VIRQ", cpu, best_irq);
+            VIRQ_OUT[cpu].write_deferred(level);
+        }
+    }
+
+    bool gic400::is_irq_eligible(unsigned int irq, unsigned int cpu) {
+        unsigned int mask = 1 << cpu;
+        if (irq >= m_irq_num || !is_irq_enabled(irq, mask))
+            return false;
+        if (is_irq_active(irq, mask) || !test_pending(irq, mask))
+            return false;
+        if (irq >= NPRIV && !(DISTIF.ITARGETS_SPI[irq - NPRIV] & mask))
+            return false;
+        return true;
+    }
+
+    void gic400::refresh_irq_cpu(unsigned int irq, unsigned int cpu) {
+        const u64 bit = 1ull << (irq % 64);
+        u64& word = m_eligible[cpu][irq / 64];
+
+        bool eligible = is_irq_eligible(irq, cpu);
+        u8 prio = eligible ? get_irq_priority(cpu, irq) : 0;
+
+        if (word & bit) {
+            u8 prev = m_eligible_prio[cpu][irq];
+            if (eligible && prio == prev)
+                return;
+
+            word &= ~bit;
+            u64& prio_word = m_prio_irqs[cpu][prev][irq / 64];
+            prio_word &= ~bit;
+            if (prio_word == 0) {
+                m_prio_words[cpu][prev] &= ~(1u << (irq / 64));
+                if (m_prio_words[cpu][prev] == 0)
+                    m_prio_used[cpu][prev / 64] &= ~(1ull << (prev % 64));
             }
         }
+
+        if (eligible) {
+            word |= bit;
+            m_eligible_prio[cpu][irq] = prio;
+
+            vector<u64>& prio_irqs = m_prio_irqs[cpu][prio];
+            if (prio_irqs.empty())
+                prio_irqs.resize(NIRQ_WORDS);
+
+            prio_irqs[irq / 64] |= bit;
+            m_prio_words[cpu][prio] |= 1u << (irq / 64);
+            m_prio_used[cpu][prio / 64] |= 1ull << (prio % 64);
+        }
+    }
+
+    void gic400::refresh_irq(unsigned int irq, unsigned int mask) {
+        for (mask &= ALL_CPU; mask != 0; mask &= mask - 1)
+            refresh_irq_cpu(irq, ctz(mask));
+    }
+
+    void gic400::refresh_all_irqs() {
+        for (unsigned int irq = 0; irq < NIRQ; irq++)
+            refresh_irq(irq, ALL_CPU);
+    }
+
+    unsigned int gic400::highest_pending_irq(unsigned int cpu,
+                                             unsigned int& prio) const {
+        unsigned int best_prio = NPRIO;
+        for (unsigned int w = 0; w < NPRIO_WORDS; w++) {
+            if (m_prio_used[cpu][w]) {
+                best_prio = w * 64 + ctz(m_prio_used[cpu][w]);
+                break;
+            }
+        }
+
+        if (best_prio >= prio)
+            return SPURIOUS_IRQ;
+
+        // lowest irq number wins among those with the highest priority
+        unsigned int w = ctz(m_prio_words[cpu][best_prio]);
+        prio = best_prio;
+        return w * 64 + ctz(m_prio_irqs[cpu][best_prio][w]);
     }
 
     u8 gic400::get_irq_priority(unsigned int cpu, unsigned int irq) {
@@ -1302,6 +1397,7 @@ namespace vcml { namespace arm {
 
         log_debug("found %u cpus with %u irqs in total", m_cpu_num, m_irq_num);
         DISTIF.setup(m_cpu_num, m_irq_num);
+        refresh_all_irqs();
     }
 
     void gic400::irq_transport(const irq_target_socket& socket,
@@ -26,20 +26,32 @@ namespace vcml { namespace arm {
         IRQS = RISR & INTE & ~INTS; // update IRQ status
 
         for (auto irq : IRQ_OUT)
-            irq.second->write(IRQS != 0u);
+            irq.second->write_deferred(IRQS != 0u);
 
         for (auto fiq : FIQ_OUT)
-            fiq.second->write(FIQS != 0u);
-
-        for (unsigned int l = 0; l < VCTRL.count(); l++) {
-            if (VCTRL[l] & VCTRL_ENABLED) {
-                u32 source = VCTRL[l] & VCTRL_SOURCE_M;
-                u32 srcmsk = 1 << source;
-                if (IRQS & srcmsk) {
-                    ADDR = VADDR[l];
-                    m_current_irq = source;
-                    m_vect_int = true;
-                }
+            fiq.second->write_deferred(FIQS != 0u);
+
+        u32 slots = 0, pending = IRQS & m_vect_sources;
+        for (; pending != 0; pending &= pending - 1)
+            slots |= 1u << m_source_slot[ctz(pending)];
+
+        if (slots != 0) {
+            unsigned int slot = ctz(slots);
+            ADDR = VADDR[slot];
+            m_current_irq = VCTRL[slot] & VCTRL_SOURCE_M;
+            m_vect_int = true;
+        }
+    }
+
+    void pl190vic::update_slots() {
+        m_vect_sources = 0;
+
+        // go backwards, so that the lowest slot for each source wins
+        for (unsigned int slot = VCTRL.count(); slot-- > 0; ) {
+            if (VCTRL[slot] & VCTRL_ENABLED) {
+                u32 source = VCTRL[slot] & VCTRL_SOURCE_M;
+                m_source_slot[source] = slot;
+                m_vect_sources |= 1u << source;
             }
         }
     }
@@ -80,7 +92,10 @@ namespace vcml { namespace arm {
     }
 
     u32 pl190vic::write_VCTRL(u32 val, size_t idx) {
-        return val & VCTRL_M;
+        VCTRL[idx] = val & VCTRL_M;
+        update_slots();
+        update();
+        return VCTRL[idx];
     }
 
     pl190vic::pl190vic(const sc_module_name& nm):
@@ -88,6 +103,8 @@ namespace vcml { namespace arm {
         m_ext_irq(0),
         m_current_irq(0xFF),
         m_vect_int(false),
+        m_vect_sources(0),
+        m_source_slot(),
         IRQS  ("IRQS",  0x000),
         FIQS  ("FIQS",  0x004),
         RISR  ("RISR",  0x008),
@@ -147,6 +164,8 @@ namespace vcml { namespace arm {
     }
 
     void pl190vic::reset() {
+        update_slots();
+
         for (unsigned int i = 0; i < PID.count(); i++)
             PID[i] = (VCML_ARM_PL190VIC_PID >> (i * 8)) & 0xFF;
 
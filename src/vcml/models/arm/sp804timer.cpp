@@ -20,43 +20,74 @@
 
 namespace vcml { namespace arm {
 
-    void sp804timer::timer::trigger() {
-        IRQ = false;
+    u32 sp804timer::timer::reload_value() const {
+        return is_periodic() ? (u32)LOAD & wrap_mask() : wrap_mask();
+    }
 
-        if (is_enabled()) {
-            if (is_irq_enabled())
-                IRQ = true;
+    sc_time sp804timer::timer::tick() const {
+        return clock_cycles(get_prescale_divider());
+    }
 
-            if (!is_oneshot())
-                schedule(is_periodic() ? LOAD : 0xFFFFFFFF);
-        }
+    u32 sp804timer::timer::current_value() const {
+        sc_time t = tick();
+        if (!is_enabled() || t == SC_ZERO_TIME)
+            return m_count;
 
-        m_timer->update_IRQC();
-    }
+        u64 elapsed = (sc_time_stamp() - m_start).value() / t.value();
+        if (elapsed < m_count)
+            return m_count - elapsed;
 
-    void sp804timer::timer::schedule(u32 ticks) {
-        m_ev.cancel();
+        u64 reload = reload_value();
+        if (is_oneshot() || reload == 0)
+            return 0;
 
-        if (!is_enabled())
-            return;
+        return reload - (elapsed - m_count) % reload;
+    }
 
-        if (!is_32bit())
-            ticks &= 0xffff;
+    void sp804timer::timer::restart(u32 count, bool inclusive) {
+        m_count = count & wrap_mask();
+        m_start = sc_time_stamp();
+        rearm(inclusive);
+    }
 
-        clock_t effclk = CLOCK / get_prescale_divider();
-        sc_time delta((double)ticks / (double)effclk, SC_SEC);
+    void sp804timer::timer::rearm(bool inclusive) {
+        // Expiries only need a kernel event if they would raise the
+        // interrupt. While it is masked or still pending, the counter
+        // just keeps running and is computed on demand in read_VALUE.
+        m_armed = false;
+
+        sc_time t = tick();
+        if (is_enabled() && is_irq_enabled() && !IRQ.read() &&
+            t != SC_ZERO_TIME) {
+            sc_time now = sc_time_stamp();
+            sc_time first = m_start + t * (double)m_count;
+            u64 reload = reload_value();
+
+            if (first > now || (inclusive && first == now)) {
+                m_deadline = first;
+                m_armed = true;
+            } else if (!is_oneshot() && reload > 0) {
+                u64 period = t.value() * reload;
+                u64 diff = (now - first).value();
+                u64 n = diff / period + 1;
+                if (inclusive && diff % period == 0)
+                    n--;
+
+                m_deadline = first + t * (double)(reload * n);
+                m_armed = true;
+            }
+        }
 
-        m_prev = sc_time_stamp();
-        m_next = m_prev + delta;
-        m_ev.notify(delta);
+        m_timer->schedule();
     }
 
-    u32 sp804timer::timer::read_VALUE() {
-        if (!is_enabled())
-            return LOAD;
+    void sp804timer::timer::expire() {
+        m_armed = false;
+        IRQ = true;
+    }
 
-        double delta = (sc_time_stamp() - m_prev) / (m_next - m_prev);
-        return LOAD * (1.0 - delta);
+    u32 sp804timer::timer::read_VALUE() {
+        return current_value();
     }
 
     u32 sp804timer::timer::read_RIS() {
@@ -70,35 +101,50 @@ namespace vcml { namespace arm {
     u32 sp804timer::timer::write_LOAD(u32 val) {
         LOAD = val;
         BGLOAD = val;
-        schedule(val);
+        restart(val, true);
         return val;
     }
 
     u32 sp804timer::timer::write_CONTROL(u32 val) {
         if (((val >> CTLR_PRESCALE_O) & CTLR_PRESCALE_M) == 3)
             log_warn("invalid prescaler value defined");
+
+        bool was_enabled = is_enabled();
+        u32 count = current_value();
+
         CONTROL = val & (u32)CONTROL_M;
-        schedule(LOAD);
+
+        if (!is_irq_enabled() && IRQ.read()) {
+            IRQ = false;
+            m_timer->update_IRQC();
+        }
+
+        // a one-shot counter that already stopped at zero must not fire again
+        restart(count, count > 0 || !was_enabled);
         return CONTROL;
     }
 
     u32 sp804timer::timer::write_INTCLR(u32 val) {
         IRQ = false;
         m_timer->update_IRQC();
+        rearm(false);
         return 0;
     }
 
     u32 sp804timer::timer::write_BGLOAD(u32 val) {
+        u32 count = current_value();
         LOAD = val;
         BGLOAD = val;
+        restart(count, false);
         return val;
     }
 
     sp804timer::timer::timer(const sc_module_name& nm):
         peripheral(nm),
-        m_ev("event"),
-        m_prev(SC_ZERO_TIME),
-        m_next(SC_ZERO_TIME),
+        m_start(SC_ZERO_TIME),
+        m_count(0xFFFFFFFF),
+        m_deadline(SC_ZERO_TIME),
+        m_armed(false),
         m_timer(dynamic_cast<sp804timer*>(get_parent_object())),
         LOAD("LOAD", 0x00, 0x00000000),
         VALUE("VALUE", 0x04, 0xFFFFFFFF),
@@ -136,10 +182,6 @@ namespace vcml { namespace arm {
         BGLOAD.sync_always();
         BGLOAD.allow_read_write();
         BGLOAD.on_write(&timer::write_BGLOAD);
-
-        SC_METHOD(trigger);
-        sensitive << m_ev;
-        dont_initialize();
     }
 
     sp804timer::timer::~timer() {
@@ -148,15 +190,46 @@ namespace vcml { namespace arm {
 
     void sp804timer::timer::reset() {
         peripheral::reset();
-        m_ev.cancel();
+
+        m_start = sc_time_stamp();
+        m_count = VALUE;
+        m_armed = false;
+        IRQ = false;
     }
 
     void sp804timer::update_IRQC() {
         IRQC = TIMER1.IRQ || TIMER2.IRQ;
     }
 
+    void sp804timer::trigger() {
+        sc_time now = sc_time_stamp();
+
+        if (TIMER1.m_armed && TIMER1.m_deadline <= now)
+            TIMER1.expire();
+        if (TIMER2.m_armed && TIMER2.m_deadline <= now)
+            TIMER2.expire();
+
+        update_IRQC();
+        schedule();
+    }
+
+    void sp804timer::schedule() {
+        m_ev.cancel();
+
+        // both counters share one event, pick whichever expires first
+        const timer* next = nullptr;
+        if (TIMER1.m_armed)
+            next = &TIMER1;
+        if (TIMER2.m_armed && (!next || TIMER2.m_deadline < next->m_deadline))
+            next = &TIMER2;
+
+        if (next != nullptr)
+            m_ev.notify(next->m_deadline - sc_time_stamp());
+    }
+
     sp804timer::sp804timer(const sc_module_name& nm):
         peripheral(nm),
+        m_ev("event"),
         TIMER1("TIMER1"),
         TIMER2("TIMER2"),
         ITCR("ITCR", 0xF00, 0x00000000),
@@ -188,6 +261,10 @@ namespace vcml { namespace arm {
 
         TIMER1.RESET.bind(RESET);
         TIMER2.RESET.bind(RESET);
+
+        SC_METHOD(trigger);
+        sensitive << m_ev;
+        dont_initialize();
     }
 
     sp804timer::~sp804timer() {
@@ -225,6 +302,7 @@ namespace vcml { namespace arm {
         for (unsigned int i = 0; i < CID.count(); i++)
             CID[i] = (SP804TIMER_CID >> (i * 8)) & 0xFF;
 
+        m_ev.cancel();
         IRQC = false;
     }
 
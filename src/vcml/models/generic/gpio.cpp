@@ -20,10 +20,32 @@
 
 namespace vcml { namespace generic {
 
+    void gpio::update_port(size_t port, u32 val) {
+        u32 changed = DATA[port] ^ val;
+        DATA[port] = val;
+
+        // only forward the lines that actually changed
+        for (; changed != 0; changed &= changed - 1) {
+            unsigned int bit = ctz(changed);
+            unsigned int line = port * 32 + bit;
+            bool state = (val >> bit) & 1;
+
+            out_port<bool>* gpio = m_lines[line];
+            if (gpio == nullptr)
+                continue;
+
+            log_debug("%s GPIO%u", state ? "setting" : "clearing", line);
+            gpio->write(state);
+        }
+    }
+
     bool gpio::cmd_status(const vector<string>& args, ostream& os) {
-        os << basename() << " status" << std::endl
-           << "  DATA: 0x" << std::hex << std::setw(8) << std::setfill('0')
-           << read_DATA() << std::dec << std::setfill(' ') << std::endl;
+        os << basename() << " status" << std::endl;
+        for (size_t port = 0; port < NPORTS; port++) {
+            os << "  DATA" << port << ": 0x" << std::hex << std::setw(8)
+               << std::setfill('0') << DATA[port] << std::dec
+               << std::setfill(' ') << std::endl;
+        }
 
         os << "Set: ";
         for (auto port : GPIO) {
@@ -44,7 +66,7 @@ namespace vcml { namespace generic {
 
     bool gpio::cmd_set(const vector<string>& args, ostream& os) {
         unsigned long long idx = strtoull(args[0].c_str(), NULL, 0);
-        if (idx > 31) {
+        if (idx >= NLINES) {
             os << "index out of bounds: " << idx;
             return false;
         }
@@ -55,13 +77,13 @@ namespace vcml { namespace generic {
         }
 
         os << "setting GPIO" << idx;
-        GPIO[idx].write(true);
+        write_line(idx, true);
         return true;
     }
 
     bool gpio::cmd_clear(const vector<string>& args, ostream& os) {
         unsigned long long idx = strtoull(args[0].c_str(), NULL, 0);
-        if (idx > 31) {
+        if (idx >= NLINES) {
             os << "index out of bounds: " << idx;
             return false;
         }
@@ -72,50 +94,51 @@ namespace vcml { namespace generic {
         }
 
         os << "clearing GPIO" << idx;
-        GPIO[idx].write(false);
+        write_line(idx, false);
         return true;
     }
 
-    u32 gpio::read_DATA() {
-        u32 result = 0;
-        for (auto gpio : GPIO) {
-            VCML_ERROR_ON(gpio.first > 31, "invalid GPIO%u", gpio.first);
-
-            if (gpio.second->read())
-                result |= (1 << gpio.first);
-        }
-
-        return result;
+    u32 gpio::write_DATA(u32 val, size_t port) {
+        update_port(port, val);
+        return val;
     }
 
-    u32 gpio::write_DATA(u32 val) {
-        for (auto gpio : GPIO) {
-            VCML_ERROR_ON(gpio.first > 31, "invalid GPIO%u", gpio.first);
-
-            u32 mask = (1 << gpio.first);
-            if ((val & mask) && !gpio.second->read()) {
-                log_debug("setting GPIO%u", gpio.first);
-                gpio.second->write(true);
-            }
+    u32 gpio::write_SET(u32 val, size_t port) {
+        update_port(port, DATA[port] | val);
+        return 0;
+    }
 
-            if (!(val & mask) && gpio.second->read()) {
-                log_debug("clearing GPIO%u", gpio.first);
-                gpio.second->write(false);
-            }
-        }
+    u32 gpio::write_CLEAR(u32 val, size_t port) {
+        update_port(port, DATA[port] & ~val);
+        return 0;
+    }
 
-        return val;
+    u32 gpio::write_TOGGLE(u32 val, size_t port) {
+        update_port(port, DATA[port] ^ val);
+        return 0;
     }
 
     gpio::gpio(const sc_module_name& nm):
         peripheral(nm),
-        DATA("DATA", 0x0, 0),
+        m_lines(),
+        DATA("DATA", 0x00, 0),
+        SET("SET", 0x20, 0),
+        CLEAR("CLEAR", 0x40, 0),
+        TOGGLE("TOGGLE", 0x60, 0),
         GPIO("PORTS"),
         IN("IN") {
         DATA.allow_read_write();
-        DATA.on_read(&gpio::read_DATA);
         DATA.on_write(&gpio::write_DATA);
 
+        SET.allow_write_only();
+        SET.on_write(&gpio::write_SET);
+
+        CLEAR.allow_write_only();
+        CLEAR.on_write(&gpio::write_CLEAR);
+
+        TOGGLE.allow_write_only();
+        TOGGLE.on_write(&gpio::write_TOGGLE);
+
         register_command("status", 0, this, &gpio::cmd_status,
                          "reports the status of all GPIO lines");
         register_command("set", 1, this, &gpio::cmd_set,
@@ -130,7 +153,23 @@ namespace vcml { namespace generic {
 
     void gpio::reset() {
         peripheral::reset();
-        DATA = write_DATA(0);
+
+        for (out_port<bool>* gpio : m_lines) {
+            if (gpio != nullptr)
+                gpio->write(false);
+        }
+    }
+
+    bool gpio::read_line(size_t line) const {
+        VCML_ERROR_ON(line >= NLINES, "invalid GPIO%zu", line);
+        return (DATA[line / 32] >> (line % 32)) & 1;
+    }
+
+    void gpio::write_line(size_t line, bool state) {
+        VCML_ERROR_ON(line >= NLINES, "invalid GPIO%zu", line);
+        u32 mask = 1u << (line % 32);
+        u32 data = DATA[line / 32];
+        update_port(line / 32, state ? data | mask : data & ~mask);
     }
 
     void gpio::end_of_elaboration() {
@@ -138,10 +177,13 @@ namespace vcml { namespace generic {
 
         bool valid_binding = true;
         for (auto port : GPIO) {
-            if (port.first > 31) {
+            if (port.first >= NLINES) {
                 log_warn("GPIO index out of bounds: %u", port.first);
                 valid_binding = false;
+                continue;
             }
+
+            m_lines[port.first] = port.second;
         }
 
         VCML_ERROR_ON(!valid_binding, "invalid port binding");
@@ -16,46 +16,178 @@
  *                                                                            *
  ******************************************************************************/
 
+#include <time.h>
+
 #include "vcml/models/meta/throttle.h"
 
 namespace vcml { namespace meta {
 
+    enum : u64 {
+        SPIN_MIN_NS = 2000,
+        SPIN_MAX_NS = 1000000,
+        CALIBRATION_ROUNDS = 8,
+        CALIBRATION_SLEEP_NS = 100000,
+    };
+
+    static void sleep_until(u64 ns) {
+        struct timespec ts;
+        ts.tv_sec = ns / 1000000000ul;
+        ts.tv_nsec = ns % 1000000000ul;
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL))
+            ; // interrupted, keep sleeping
+    }
+
+    static u64 clamp_spin(u64 ns) {
+        return min<u64>(max<u64>(ns, SPIN_MIN_NS), SPIN_MAX_NS);
+    }
+
+    void throttle::calibrate() {
+        u64 overshoot = 0;
+        for (u64 i = 0; i < CALIBRATION_ROUNDS; i++) {
+            u64 wakeup = timestamp_ns() + CALIBRATION_SLEEP_NS;
+            sleep_until(wakeup);
+            overshoot = max(overshoot, timestamp_ns() - wakeup);
+        }
+
+        m_spin_ns = clamp_spin(overshoot + overshoot / 4);
+        log_debug("sleep overshoot %luns, spinning %luns", overshoot,
+                  m_spin_ns);
+    }
+
+    u64 throttle::pace(u64 deadline) {
+        u64 now = timestamp_ns();
+        if (deadline > now + m_spin_ns) {
+            u64 wakeup = deadline - m_spin_ns;
+            sleep_until(wakeup);
+            now = timestamp_ns();
+
+            // follow the observed wakeup latency, so that we rarely wake up
+            // too late but also do not burn more time spinning than needed
+            u64 late = now > wakeup ? now - wakeup : 0;
+            m_spin_ns = clamp_spin((7 * m_spin_ns + late + late / 4) / 8);
+        }
+
+        while (now < deadline)
+            now = timestamp_ns();
+
+        return now;
+    }
+
     void throttle::update() {
         sc_time quantum = tlm::tlm_global_quantum::instance().get();
         sc_time interval = max(update_interval.get(), quantum);
         next_trigger(interval);
 
-        if (rtf > 0.0) {
-            u64 actual = realtime_us() - m_time_real;
-            u64 target = time_to_us(interval) / rtf;
-
-            if (actual < target) {
-                usleep(target - actual);
-                if (!m_throttling)
-                    log_debug("throttling started");
-                m_throttling = true;
-            } else {
-                if (m_throttling)
-                    log_debug("throttling stopped");
-                m_throttling = false;
+        if (rtf <= 0.0) {
+            if (m_throttling)
+                log_debug("throttling stopped");
+            m_throttling = false;
+            m_window.clear();
+            return;
+        }
+
+        u64 now = timestamp_ns();
+        u64 sim = time_to_ns(sc_time_stamp());
+
+        if (m_window.empty() || m_rtf != rtf) {
+            if (m_spin_ns == 0) {
+                calibrate();
+                now = timestamp_ns();
             }
+
+            if (m_start_ns == 0)
+                m_start_ns = now;
+
+            m_rtf = rtf;
+            m_window.clear();
+            m_window.push_back({sim, now});
+            return;
         }
 
-        m_time_real = realtime_us();
+        // pace against the oldest sample in the window, so that oversleeping
+        // or lagging behind in one interval is made up for in the next ones
+        const sample& ref = m_window.front();
+        u64 target = ref.real_ns + (u64)((sim - ref.sim_ns) / m_rtf);
+
+        if (now < target) {
+            u64 woken = pace(target);
+            m_sleep_ns += woken - now;
+            now = woken;
+
+            if (!m_throttling)
+                log_debug("throttling started");
+            m_throttling = true;
+        } else {
+            if (m_throttling)
+                log_debug("throttling stopped");
+            m_throttling = false;
+        }
+
+        u64 lag = now - target;
+        m_lag_max = max(m_lag_max, lag);
+        m_lag_sum += lag;
+        m_updates++;
+
+        m_window.push_back({sim, now});
+        while (m_window.size() > window + 1)
+            m_window.pop_front();
+    }
+
+    bool throttle::cmd_stats(const vector<string>& args, ostream& os) {
+        os << "rtf:        " << mkstr("%.2f", rtf.get()) << std::endl
+           << "throttling: " << (m_throttling ? "yes" : "no") << std::endl
+           << "updates:    " << m_updates << std::endl
+           << "spin time:  " << mkstr("%.1fus", m_spin_ns / 1e3) << std::endl
+           << "max lag:    " << mkstr("%.1fus", m_lag_max / 1e3) << std::endl
+           << "avg lag:    " << mkstr("%.1fus", avg_lag_ns() / 1e3)
+           << std::endl
+           << "sleeping:   " << mkstr("%.1f%%", sleep_ratio() * 100.0);
+        return true;
     }
 
     throttle::throttle(const sc_module_name& nm):
         module(nm),
         m_throttling(false),
-        m_time_real(realtime_us()),
+        m_rtf(0.0),
+        m_spin_ns(0),
+        m_window(),
+        m_start_ns(0),
+        m_sleep_ns(0),
+        m_updates(0),
+        m_lag_max(0),
+        m_lag_sum(0),
         update_interval("update_interval", sc_time(10.0, SC_MS)),
-        rtf("rtf", 0.0) {
+        rtf("rtf", 0.0),
+        window("window", 10) {
         SC_HAS_PROCESS(throttle);
         SC_METHOD(update);
+
+        register_command("stats", 0, this, &throttle::cmd_stats,
+                         "reports lag and sleep statistics of the throttle");
     }
 
     throttle::~throttle() {
         // nothing to do
     }
 
+    u64 throttle::avg_lag_ns() const {
+        return m_updates ? m_lag_sum / m_updates : 0;
+    }
+
+    double throttle::sleep_ratio() const {
+        if (m_start_ns == 0)
+            return 0.0;
+
+        u64 total = timestamp_ns() - m_start_ns;
+        return total ? (double)m_sleep_ns / total : 0.0;
+    }
+
+    void throttle::reset_stats() {
+        m_start_ns = m_start_ns ? timestamp_ns() : 0;
+        m_sleep_ns = 0;
+        m_updates = 0;
+        m_lag_max = 0;
+        m_lag_sum = 0;
+    }
+
 }}
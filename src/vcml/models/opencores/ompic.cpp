@@ -26,7 +26,7 @@ namespace vcml { namespace opencores {
     u32 ompic::read_STATUS(size_t core_idx) {
         VCML_ERROR_ON(core_idx >= m_num_cores, "core_id >= num_cores");
         u32 val = m_status[core_idx];
-        if (IRQ[core_idx].read())
+        if (m_irq[core_idx] && m_irq[core_idx]->read())
             val |= CTRL_IRQ_GEN;
         return val;
     }
@@ -52,30 +52,46 @@ namespace vcml { namespace opencores {
         }
 
         m_control[core_idx] = val;
-        if (val & CTRL_IRQ_GEN) {
-            m_status[dest] = self << 16 | data;
-            log_debug("cpu%d triggers interrupt on cpu%d (data: 0x%04x)",
-                      self, dest, data);
-            if (IRQ[dest].read())
-                log_debug("interrupt already pending for cpu%d", dest);
-            IRQ[dest] = true;
-        }
-
-        if (val & CTRL_IRQ_ACK) {
-            log_debug("cpu%d acknowledges interrupt", self);
-            if (!IRQ[self].read())
-                log_debug("no pending interrupt for cpu%d", self);
-            IRQ[self] = false;
-        }
+        if (val & CTRL_IRQ_GEN)
+            send_ipi(self, dest, data);
+        if (val & CTRL_IRQ_ACK)
+            ack_ipi(self);
 
         return val;
     }
 
+    void ompic::send_ipi(unsigned int self, unsigned int dest, u16 data) {
+        VCML_ERROR_ON(dest >= m_num_cores, "dest >= num_cores");
+
+        m_status[dest] = self << 16 | data;
+        log_debug("cpu%u triggers interrupt on cpu%u (data: 0x%04hx)",
+                  self, dest, data);
+
+        irq_initiator_socket* irq = m_irq[dest];
+        VCML_ERROR_ON(!irq, "cpu%u interrupt not connected", dest);
+        if (irq->read())
+            log_debug("interrupt already pending for cpu%u", dest);
+        irq->write(true);
+    }
+
+    void ompic::ack_ipi(unsigned int self) {
+        VCML_ERROR_ON(self >= m_num_cores, "self >= num_cores");
+
+        log_debug("cpu%u acknowledges interrupt", self);
+
+        irq_initiator_socket* irq = m_irq[self];
+        VCML_ERROR_ON(!irq, "cpu%u interrupt not connected", self);
+        if (!irq->read())
+            log_debug("no pending interrupt for cpu%u", self);
+        irq->write(false);
+    }
+
     ompic::ompic(const sc_core::sc_module_name& nm, unsigned int num_cores):
         peripheral(nm),
         m_num_cores(num_cores),
         m_control(nullptr),
         m_status(nullptr),
+        m_irq(num_cores, nullptr),
         CONTROL(nullptr),
         STATUS(nullptr),
         IRQ("IRQ"),
@@ -121,4 +137,10 @@ namespace vcml { namespace opencores {
         delete [] m_status;
     }
 
+    void ompic::end_of_elaboration() {
+        // IRQ is a sparse socket array, cache the sockets for fast lookup
+        for (unsigned int core = 0; core < m_num_cores; core++)
+            m_irq[core] = IRQ.exists(core) ? &IRQ[core] : nullptr;
+    }
+
 }}
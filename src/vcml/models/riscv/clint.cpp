@@ -25,6 +25,73 @@ namespace vcml { namespace riscv {
         return delta / clock_cycle();
     }
 
+    u64 clint::heap_key(size_t pos) const {
+        return MTIMECMP.get(m_heap[pos]);
+    }
+
+    void clint::heap_swap(size_t a, size_t b) {
+        std::swap(m_heap[a], m_heap[b]);
+        m_heap_pos[m_heap[a]] = a;
+        m_heap_pos[m_heap[b]] = b;
+    }
+
+    void clint::heap_sift_up(size_t pos) {
+        while (pos > 0) {
+            size_t parent = (pos - 1) / 2;
+            if (heap_key(parent) <= heap_key(pos))
+                break;
+
+            heap_swap(parent, pos);
+            pos = parent;
+        }
+    }
+
+    void clint::heap_sift_down(size_t pos) {
+        while (true) {
+            size_t min = pos;
+            size_t l = 2 * pos + 1;
+            size_t r = 2 * pos + 2;
+
+            if (l < m_heap.size() && heap_key(l) < heap_key(min))
+                min = l;
+            if (r < m_heap.size() && heap_key(r) < heap_key(min))
+                min = r;
+            if (min == pos)
+                break;
+
+            heap_swap(pos, min);
+            pos = min;
+        }
+    }
+
+    void clint::heap_update(size_t hart) {
+        size_t pos = m_heap_pos[hart];
+        if (pos == SIZE_MAX) {
+            pos = m_heap.size();
+            m_heap.push_back(hart);
+            m_heap_pos[hart] = pos;
+        }
+
+        heap_sift_up(pos);
+        heap_sift_down(m_heap_pos[hart]);
+    }
+
+    void clint::heap_remove(size_t hart) {
+        size_t pos = m_heap_pos[hart];
+        if (pos == SIZE_MAX)
+            return;
+
+        heap_swap(pos, m_heap.size() - 1);
+        m_heap.pop_back();
+        m_heap_pos[hart] = SIZE_MAX;
+
+        if (pos < m_heap.size()) {
+            size_t moved = m_heap[pos];
+            heap_sift_up(pos);
+            heap_sift_down(m_heap_pos[moved]);
+        }
+    }
+
     u32 clint::read_MSIP(size_t hart) {
         if (!IRQ_SW.exists(hart))
             return 0;
@@ -50,7 +117,17 @@ namespace vcml { namespace riscv {
             return 0;
 
         MTIMECMP[hart] = val;
-        update_timer();
+
+        u64 mtime = get_cycles();
+        if (mtime >= val) {
+            heap_remove(hart);
+            log_debug("triggering hart %zu timer interrupt", hart);
+        } else {
+            heap_update(hart);
+        }
+
+        IRQ_TIMER[hart].write(mtime >= val);
+        schedule_timer(mtime);
         return val;
     }
 
@@ -61,24 +138,29 @@ namespace vcml { namespace riscv {
     void clint::update_timer() {
         u64 mtime = get_cycles();
 
-        for (auto it : IRQ_TIMER) {
-            auto hart = it.first;
-            auto port = it.second;
-
-            u64 mcomp = MTIMECMP.get(hart);
-            port->write(mtime >= mcomp);
+        while (!m_heap.empty() && heap_key(0) <= mtime) {
+            size_t hart = m_heap[0];
+            heap_remove(hart);
 
-            if (mtime >= mcomp)
-                log_debug("triggering hart %zu timer interrupt", it.first);
-            else
-                m_trigger.notify(clock_cycles(mcomp - mtime));
+            log_debug("triggering hart %zu timer interrupt", hart);
+            IRQ_TIMER[hart].write(true);
         }
+
+        schedule_timer(mtime);
+    }
+
+    void clint::schedule_timer(u64 mtime) {
+        m_trigger.cancel();
+        if (!m_heap.empty())
+            m_trigger.notify(clock_cycles(heap_key(0) - mtime));
     }
 
     clint::clint(const sc_module_name& nm):
         peripheral(nm),
         m_time_reset(),
         m_trigger("triggerev"),
+        m_heap(),
+        m_heap_pos(NHARTS, SIZE_MAX),
         MSIP("MSIP", 0x0000, 0),
         MTIMECMP("MTIMECMP", 0x4000, 0),
         MTIME("MTIME", 0xbff8, 0),
@@ -112,6 +194,12 @@ namespace vcml { namespace riscv {
         peripheral::reset();
 
         m_time_reset = sc_time_stamp();
+
+        for (size_t hart : m_heap)
+            m_heap_pos[hart] = SIZE_MAX;
+
+        m_heap.clear();
+        m_trigger.cancel();
     }
 
 }}
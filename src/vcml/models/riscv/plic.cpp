@@ -21,6 +21,11 @@
 namespace vcml { namespace riscv {
 
     plic::context::context(const string& nm, size_t no):
+        id(no),
+        enabled(),
+        pending(),
+        best(0),
+        dirty(false),
         ENABLED(),
         THRESHOLD(mkstr("CTX%zu_THRESHOLD", no).c_str(), BASE + no * SIZE + 0),
         CLAIM(mkstr("CTX%zu_CLAIM", no).c_str(), BASE + no * SIZE + 4) {
@@ -66,22 +71,6 @@ namespace vcml { namespace riscv {
         return m_claims[irqno] < NCTX;
     }
 
-    bool plic::is_enabled(size_t irqno, size_t ctxno) const {
-        VCML_ERROR_ON(irqno >= NIRQ, "invalid irq %zu", irqno);
-        VCML_ERROR_ON(ctxno >= NCTX, "invalid context %zu", ctxno);
-
-        if (irqno == 0)
-            return false;
-
-        if (m_contexts[ctxno] == nullptr)
-            return false;
-
-        unsigned int regno = irqno / 32;
-        unsigned int shift = irqno % 32;
-
-        return (m_contexts[ctxno]->ENABLED[regno]->get() >> shift) & 0b1;
-    }
-
     u32 plic::irq_priority(size_t irqno) const {
         if (irqno == 0) {
             log_debug("attempt to read priority of invalid irq%zu\n", irqno);
@@ -114,46 +103,77 @@ namespace vcml { namespace riscv {
     }
 
     u32 plic::read_CLAIM(size_t ctxno) {
-        unsigned int irq = 0;
-        unsigned int threshold = ctx_threshold(ctxno);
-
-        for (unsigned int irqno = 0; irqno < NIRQ; irqno++) {
-            if (is_pending(irqno)
-                && is_enabled(irqno, ctxno)
-                && !is_claimed(irqno)
-                && irq_priority(irqno) > threshold) {
-                irq = irqno;
-                threshold = irq_priority(irqno);
-            }
-        }
-
-        if (irq > 0)
+        context* ctx = m_contexts[ctxno];
+        unsigned int irq = best_candidate(ctx);
+        if (irq > 0 && irq_priority(irq) > ctx_threshold(ctxno)) {
             m_claims[irq] = ctxno;
+            set_available(irq, false);
+        } else {
+            irq = 0;
+        }
 
         log_debug("context %zu claims irq %u", ctxno, irq);
 
-        update();
-
         return irq;
     }
 
     u32 plic::write_PRIORITY(u32 value, size_t irqno) {
+        u32 prev = PRIORITY.get(irqno);
         PRIORITY.get(irqno) = value;
-        update();
+
+        u64 mask = 1ull << (irqno % 64);
+        if (value == prev || !(m_pending[irqno / 64] & mask))
+            return value;
+
+        for (context* ctx : m_active) {
+            if (!(ctx->pending[irqno / 64] & mask))
+                continue;
+
+            if (ctx->best == irqno && value < prev)
+                ctx->dirty = true;
+            else if (!ctx->dirty && is_better(irqno, ctx->best))
+                ctx->best = irqno;
+
+            update(ctx);
+        }
+
         return value;
     }
 
     u32 plic::write_ENABLED(u32 value, size_t regno) {
         unsigned int ctxno = regno / (NIRQ / 32);
         unsigned int subno = regno % (NIRQ / 32);
-        m_contexts[ctxno]->ENABLED[subno]->set(value);
-        update();
+        context* ctx = m_contexts[ctxno];
+
+        u32 prev = ctx->ENABLED[subno]->get();
+        ctx->ENABLED[subno]->set(value);
+        if (value == prev)
+            return value;
+
+        unsigned int word = subno / 2;
+        unsigned int shift = (subno % 2) * 32;
+
+        ctx->enabled[word] &= ~((u64)~0u << shift);
+        ctx->enabled[word] |= (u64)value << shift;
+
+        u64 changed = ((u64)(prev ^ value) << shift) & m_pending[word];
+        while (changed) {
+            unsigned int bit = ctz(changed);
+            changed &= changed - 1;
+
+            if (ctx->enabled[word] & (1ull << bit))
+                offer(ctx, word * 64 + bit);
+            else
+                withdraw(ctx, word * 64 + bit);
+        }
+
+        update(ctx);
         return value;
     }
 
     u32 plic::write_THRESHOLD(u32 value, size_t ctxno) {
         m_contexts[ctxno]->THRESHOLD = value;
-        update();
+        update(m_contexts[ctxno]);
         return value;
     }
 
@@ -168,35 +188,94 @@ namespace vcml { namespace riscv {
             log_debug("context %zu completes unclaimed irq %u", ctxno, value);
 
         m_claims[irq] = ~0u;
-        update();
+        set_available(irq, is_pending(irq));
 
         return value;
     }
 
-    void plic::update() {
-        for (auto ctx : IRQT) {
-            ctx.second->write(false);
-            u32 th = ctx_threshold(ctx.first);
-
-            for (auto irq : IRQS) {
-                if (is_pending(irq.first)
-                    && is_enabled(irq.first, ctx.first)
-                    && !is_claimed(irq.first)
-                    && irq_priority(irq.first) > th) {
-
-                    ctx.second->write(true);
-                    log_debug("forwarding irq %zu to context %zu", irq.first,
-                              ctx.first);
-                }
+    bool plic::is_better(size_t irqno, u32 than) const {
+        u32 prio = PRIORITY.get(irqno);
+        if (than == 0)
+            return prio > 0;
+
+        // on equal priority, the interrupt with the lower id wins
+        u32 other = PRIORITY.get(than);
+        return prio > other || (prio == other && irqno < than);
+    }
+
+    void plic::offer(context* ctx, size_t irqno) {
+        ctx->pending[irqno / 64] |= 1ull << (irqno % 64);
+        if (!ctx->dirty && is_better(irqno, ctx->best))
+            ctx->best = irqno;
+    }
+
+    void plic::withdraw(context* ctx, size_t irqno) {
+        ctx->pending[irqno / 64] &= ~(1ull << (irqno % 64));
+        if (ctx->best == irqno)
+            ctx->dirty = true;
+    }
+
+    void plic::set_available(size_t irqno, bool available) {
+        u64& word = m_pending[irqno / 64];
+        u64 mask = 1ull << (irqno % 64);
+        if (!(word & mask) == !available)
+            return;
+
+        if (available)
+            word |= mask;
+        else
+            word &= ~mask;
+
+        for (context* ctx : m_active) {
+            if (!(ctx->enabled[irqno / 64] & mask))
+                continue;
+
+            if (available)
+                offer(ctx, irqno);
+            else
+                withdraw(ctx, irqno);
+
+            update(ctx);
+        }
+    }
+
+    u32 plic::best_candidate(context* ctx) {
+        if (!ctx->dirty)
+            return ctx->best;
+
+        ctx->best = 0;
+        for (unsigned int word = 0; word < NWORDS; word++) {
+            u64 bits = ctx->pending[word];
+            while (bits) {
+                unsigned int irqno = word * 64 + ctz(bits);
+                bits &= bits - 1;
+                if (is_better(irqno, ctx->best))
+                    ctx->best = irqno;
             }
         }
+
+        ctx->dirty = false;
+        return ctx->best;
+    }
+
+    void plic::update(context* ctx) {
+        u32 irq = best_candidate(ctx);
+        bool active = irq > 0 && irq_priority(irq) > ctx->THRESHOLD;
+
+        irq_initiator_socket& irqt = IRQT[ctx->id];
+        if (active && !irqt.read())
+            log_debug("forwarding irq %u to context %zu", irq, ctx->id);
+
+        irqt.write_deferred(active);
     }
 
     plic::plic(const sc_module_name& nm):
         peripheral(nm),
         irq_target(),
         m_claims(),
+        m_pending(),
         m_contexts(),
+        m_active(),
         PRIORITY("PRIORITY", 0x0, 0),
         PENDING("PENDING", 0x1000, 0),
         IRQS("IRQS"),
@@ -225,12 +304,30 @@ namespace vcml { namespace riscv {
 
         for (unsigned int irq = 0; irq < NIRQ; irq++)
             m_claims[irq] = ~0u;
+
+        for (u64& word : m_pending)
+            word = 0;
+
+        for (auto irq : IRQS) {
+            if (is_pending(irq.first))
+                m_pending[irq.first / 64] |= 1ull << (irq.first % 64);
+        }
+
+        for (context* ctx : m_active) {
+            for (unsigned int word = 0; word < NWORDS; word++)
+                ctx->enabled[word] = ctx->pending[word] = 0;
+
+            ctx->best = 0;
+            ctx->dirty = false;
+            update(ctx);
+        }
     }
 
     void plic::end_of_elaboration() {
         for (auto ctx : IRQT) {
             string nm = mkstr("CONTEXT%zu", ctx.first);
             m_contexts[ctx.first] = new context(nm.c_str(), ctx.first);
+            m_active.push_back(m_contexts[ctx.first]);
         }
 
         VCML_ERROR_ON(IRQS.exists(0), "irq0 must not be used");
@@ -239,7 +336,7 @@ namespace vcml { namespace riscv {
     void plic::irq_transport(const irq_target_socket& sock, irq_payload& irq) {
         unsigned int irqno = IRQS.index_of(sock);
         log_debug("irq %u %s", irqno, irq.active ? "set" : "cleared");
-        update();
+        set_available(irqno, is_pending(irqno) && !is_claimed(irqno));
     }
 
 }}
@@ -16,7 +16,10 @@
  *                                                                            *
  ******************************************************************************/
 
+#include <fnmatch.h>
+
 #include "vcml/module.h"
+#include "vcml/protocols/tlm_sbi.h"
 
 namespace vcml {
 
@@ -43,22 +46,91 @@ namespace vcml {
     }
 
     log_level module::default_log_level() const {
+        module* parent = parent_module();
+        return parent ? parent->loglvl.get() : LOG_INFO;
+    }
+
+    module* module::parent_module() const {
         sc_object* obj = get_parent_object();
         while (obj != nullptr) {
             module* comp = dynamic_cast<module*>(obj);
             if (comp)
-                return comp->loglvl;
+                return comp;
             obj = obj->get_parent_object();
         }
 
-        return LOG_INFO;
+        return nullptr;
+    }
+
+    bool module::lookup_traced(const void* port, const char* name) {
+        auto it = m_trace_ports.find(port);
+        if (it != m_trace_ports.end())
+            return it->second;
+
+        const char* base = strrchr(name, SC_HIERARCHY_CHAR);
+        base = base ? base + 1 : name;
+
+        bool traced = false;
+        for (const string& glob : m_trace_globs) {
+            if (fnmatch(glob.c_str(), name, 0) == 0 ||
+                fnmatch(glob.c_str(), base, 0) == 0)
+                traced = true;
+        }
+
+        m_trace_ports[port] = traced;
+        return traced;
+    }
+
+    bool module::trace_accept(const tlm_generic_payload& tx) const {
+        if (tx.is_read() && !trace_reads)
+            return false;
+        if (tx.is_write() && !trace_writes)
+            return false;
+
+        const tlm_sbi& info = tx_get_sbi(tx);
+        if (info.is_debug && !trace_debug)
+            return false;
+        if (info.is_insn && !trace_insn)
+            return false;
+
+        u64 start = tx.get_address();
+        u64 size = max(tx.get_data_length(), 1u);
+        u64 end = start > ~0ull - (size - 1) ? ~0ull : start + size - 1;
+        return start <= trace_end && end >= trace_start;
     }
 
+#ifndef VCML_OMIT_LOGGING_SOURCE
+    void module::log_publish(log_level lvl, const char* file, int line,
+                             const char* format, ...) const {
+        va_list args; va_start(args, format);
+        logger::publish(lvl, name(), vmkstr(format, args), file, line);
+        va_end(args);
+    }
+#endif
+
     module::module(const sc_module_name& nm):
         sc_module(nm),
         m_commands(),
+        m_trace_globs(),
+        m_trace_all(true),
+        m_trace_ports(),
         trace_errors("trace_errors", false),
-        loglvl("loglvl", trace_errors ? LOG_TRACE : default_log_level()) {
+        loglvl("loglvl", trace_errors ? LOG_TRACE : default_log_level()),
+        trace_sockets("trace_sockets",
+                      inherit(&module::trace_sockets, string("*"))),
+        trace_start("trace_start", inherit(&module::trace_start, (u64)0)),
+        trace_end("trace_end", inherit(&module::trace_end, ~(u64)0)),
+        trace_reads("trace_reads", inherit(&module::trace_reads, true)),
+        trace_writes("trace_writes", inherit(&module::trace_writes, true)),
+        trace_debug("trace_debug", inherit(&module::trace_debug, true)),
+        trace_insn("trace_insn", inherit(&module::trace_insn, true)) {
+        auto delim = [](int c) -> int { return isspace(c) || c == ','; };
+        for (const string& glob : split(trace_sockets, delim))
+            if (!glob.empty())
+                m_trace_globs.push_back(glob);
+
+        m_trace_all = stl_contains(m_trace_globs, string("*"));
+
         register_command("clist", 0, this, &module::cmd_clist,
                          "returns a list of supported commands");
         register_command("cinfo", 1, this, &module::cmd_cinfo,
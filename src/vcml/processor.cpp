@@ -23,6 +23,35 @@
 
 namespace vcml {
 
+    static size_t irq_stats_bucket(const sc_time& t) {
+        int bucket = fls(time_to_ns(t));
+        if (bucket < 0)
+            return 0;
+        return min((size_t)bucket, (size_t)IRQ_STATS_BUCKETS - 1);
+    }
+
+    static void dump_irq_histogram(ostream& os, const char* name,
+                                   const u64 hist[IRQ_STATS_BUCKETS]) {
+        os << "    " << name << ":";
+        for (size_t i = 0; i < IRQ_STATS_BUCKETS; i++) {
+            if (hist[i] > 0)
+                os << " " << (i ? 1ull << i : 0ull) << "ns:" << hist[i];
+        }
+        os << std::endl;
+    }
+
+    static u64 irq_rate_first(const irq_stats& stats) {
+        u64 n = min<u64>(stats.irq_rate.size(), stats.irq_rate_last + 1);
+        return stats.irq_rate_last + 1 - n;
+    }
+
+    static void write_irq_array(ostream& os, const u64* data, size_t n) {
+        os << "[";
+        for (size_t i = 0; i < n; i++)
+            os << (i ? "," : "") << data[i];
+        os << "]";
+    }
+
     bool processor::cmd_dump(const vector<string>& args, ostream& os) {
         os << "Registers:" << std::endl
            << "  PC 0x" << HEX(program_counter(), 16) << std::endl
@@ -49,6 +78,21 @@ namespace vcml {
                    << "avg " << avg * 1e6 << "us\\, "
                    << "max " << max * 1e6 << "us"
                    << std::endl;
+
+                dump_irq_histogram(os, "asserted", stats.irq_duration);
+                dump_irq_histogram(os, "interval", stats.irq_interval);
+
+                if (!stats.irq_rate.empty()) {
+                    u64 first = irq_rate_first(stats), peak = first;
+                    for (u64 w = first; w <= stats.irq_rate_last; w++)
+                        if (stats.rate(w) > stats.rate(peak))
+                            peak = w;
+
+                    os << "    rate: peak " << stats.rate(peak)
+                       << " events in window " << peak << " of "
+                       << first << ".." << stats.irq_rate_last << " ("
+                       << irq_stats_window.get() << " each)" << std::endl;
+                }
             }
         }
 
@@ -213,6 +257,13 @@ namespace vcml {
             // check for standby requests
             wait_clock_reset();
 
+            // halted by a non-stop debugger, let the other cores continue
+            if (is_halted()) {
+                sc_time quantum = tlm_global_quantum::instance().get();
+                wait(max(quantum, clock_cycle()));
+                continue;
+            }
+
             do {
                 debugging::suspender::handle_requests();
                 if (!sim_running())
@@ -239,7 +290,7 @@ namespace vcml {
 
                 if (is_stepping())
                     notify_singlestep();
-            } while (!needs_sync());
+            } while (!needs_sync() && !is_halted());
 
             sync();
 
@@ -259,6 +310,8 @@ namespace vcml {
         m_run_time(0),
         m_cycle_count(0),
         m_gdb(nullptr),
+        m_irq_window(0),
+        m_irq_windows(0),
         m_irq_stats(),
         m_regprops(),
         cpuarch("arch", cpuarch),
@@ -266,6 +319,9 @@ namespace vcml {
         gdb_port("gdb_port", -1),
         gdb_wait("gdb_wait", false),
         gdb_echo("gdb_echo", false),
+        irq_stats_window("irq_stats_window", SC_ZERO_TIME),
+        irq_stats_windows("irq_stats_windows", 1024),
+        irq_stats_file("irq_stats_file", ""),
         IRQ("IRQ"),
         INSN("INSN"),
         DATA("DATA") {
@@ -331,13 +387,48 @@ namespace vcml {
     }
 
     bool processor::get_irq_stats(unsigned int irq, irq_stats& stats) const {
-        if (m_irq_stats.find(irq) == m_irq_stats.end())
+        if (irq >= m_irq_stats.size() || !IRQ.exists(irq))
             return false;
 
-        stats = m_irq_stats.at(irq);
+        stats = m_irq_stats[irq];
         return true;
     }
 
+    void processor::write_irq_stats(ostream& os) const {
+        os << "{\"processor\":\"" << name() << "\","
+           << "\"window_ns\":" << time_to_ns(irq_stats_window) << ","
+           << "\"irqs\":[";
+
+        bool first = true;
+        for (const irq_stats& stats : m_irq_stats) {
+            if (!IRQ.exists(stats.irq))
+                continue;
+
+            os << (first ? "" : ",") << std::endl
+               << "{\"irq\":" << stats.irq << ","
+               << "\"count\":" << stats.irq_count << ","
+               << "\"uptime_ns\":" << time_to_ns(stats.irq_uptime) << ","
+               << "\"longest_ns\":" << time_to_ns(stats.irq_longest) << ","
+               << "\"duration\":";
+            write_irq_array(os, stats.irq_duration, IRQ_STATS_BUCKETS);
+            os << ",\"interval\":";
+            write_irq_array(os, stats.irq_interval, IRQ_STATS_BUCKETS);
+            vector<u64> rate;
+            u64 rate_first = irq_rate_first(stats);
+            if (!stats.irq_rate.empty()) {
+                for (u64 w = rate_first; w <= stats.irq_rate_last; w++)
+                    rate.push_back(stats.rate(w));
+            }
+
+            os << ",\"rate_first\":" << rate_first << ",\"rate\":";
+            write_irq_array(os, rate.data(), rate.size());
+            os << "}";
+            first = false;
+        }
+
+        os << "]}" << std::endl;
+    }
+
     void processor::log_bus_error(const tlm_initiator_socket& socket,
         vcml_access rwx, tlm_response_status rs, u64 addr, u64 size) {
         string op;
@@ -372,15 +463,37 @@ namespace vcml {
         }
 
         stats.irq_status = tx.active;
+        const sc_time& now = sc_time_stamp();
 
         if (tx.active) {
+            if (stats.irq_count > 0)
+                stats.irq_interval[irq_stats_bucket(now - stats.irq_last)]++;
+
             stats.irq_count++;
-            stats.irq_last = sc_time_stamp();
+            stats.irq_last = now;
+
+            if (m_irq_window > 0 && m_irq_windows > 0) {
+                vector<u64>& ring = stats.irq_rate;
+                u64 window = now.value() / m_irq_window;
+                if (ring.empty()) {
+                    ring.assign(m_irq_windows, 0);
+                    stats.irq_rate_last = window;
+                }
+
+                // zero the ring slots of all windows that passed since
+                u64 limit = min<u64>(window, stats.irq_rate_last + ring.size());
+                for (u64 w = stats.irq_rate_last + 1; w <= limit; w++)
+                    ring[w % ring.size()] = 0;
+
+                stats.irq_rate_last = max(stats.irq_rate_last, window);
+                ring[window % ring.size()]++;
+            }
         } else {
-            sc_time delta = sc_time_stamp() - stats.irq_last;
+            sc_time delta = now - stats.irq_last;
             if (delta > stats.irq_longest)
                 stats.irq_longest = delta;
             stats.irq_uptime += delta;
+            stats.irq_duration[irq_stats_bucket(delta)]++;
         }
 
         log_debug("%sing IRQ %u", tx.active ? "sett" : "clear", irq);
@@ -403,15 +516,15 @@ namespace vcml {
     }
 
     void processor::end_of_elaboration() {
-        for (auto it : IRQ) {
-            irq_stats& stats = m_irq_stats[it.first];
-            stats.irq = it.first;
-            stats.irq_count = 0;
-            stats.irq_status = false;
-            stats.irq_last = SC_ZERO_TIME;
-            stats.irq_uptime = SC_ZERO_TIME;
-            stats.irq_longest = SC_ZERO_TIME;
-        }
+        size_t nirq = 0;
+        for (auto it : IRQ)
+            nirq = max(nirq, it.first + 1);
+
+        m_irq_window = irq_stats_window.get().value();
+        m_irq_windows = irq_stats_windows;
+        m_irq_stats.assign(nirq, irq_stats());
+        for (auto it : IRQ)
+            m_irq_stats[it.first].irq = it.first;
 
         if (gdb_port >= 0) {
             debugging::gdb_status status = gdb_wait ? debugging::GDB_STOPPED
@@ -428,6 +541,22 @@ namespace vcml {
         }
     }
 
+    void processor::end_of_simulation() {
+        component::end_of_simulation();
+
+        const string& filename = irq_stats_file.get();
+        if (filename.empty())
+            return;
+
+        ofstream file(filename.c_str());
+        if (!file.is_open()) {
+            log_warn("cannot open file '%s'", filename.c_str());
+            return;
+        }
+
+        write_irq_stats(file);
+    }
+
     void processor::fetch_cpuregs() {
         for (auto it : m_regprops) {
             const debugging::cpureg* reg = find_cpureg(it.first);
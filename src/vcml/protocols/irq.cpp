@@ -73,11 +73,75 @@ namespace vcml {
         m_stub->IRQ_OUT.bind(*this);
     }
 
+    struct irq_defer_state {
+        size_t depth;
+        vector<irq_initiator_socket*> sockets;
+    };
+
+    // every transport looks up its process, but consecutive transports
+    // mostly come from the same one, so remember the last state found
+    static sc_process_b* g_defer_proc = nullptr;
+    static irq_defer_state* g_defer_state = nullptr;
+
+    static irq_defer_state& current_defer_state() {
+        static unordered_map<sc_process_b*, irq_defer_state> states;
+        static size_t limit = 64;
+
+        sc_process_b* proc = current_process();
+        if (g_defer_state && g_defer_proc == proc)
+            return *g_defer_state;
+
+        // idle entries are not referenced by any guard or socket, so drop
+        // them once in a while to forget about terminated processes
+        if (states.size() >= limit) {
+            for (auto it = states.begin(); it != states.end();) {
+                if (it->second.depth == 0 && it->second.sockets.empty())
+                    it = states.erase(it);
+                else
+                    it++;
+            }
+
+            limit = max<size_t>(64, 2 * states.size());
+        }
+
+        g_defer_proc = proc;
+        g_defer_state = &states[proc];
+        return *g_defer_state;
+    }
+
+    static void flush_deferred(irq_defer_state& state) {
+        // flushing removes the socket from the list, but may also defer
+        // new writes further downstream
+        while (!state.sockets.empty())
+            state.sockets.back()->flush_deferred();
+    }
+
+    irq_defer_guard::irq_defer_guard():
+        m_state(&current_defer_state()) {
+        m_state->depth++;
+    }
+
+    irq_defer_guard::~irq_defer_guard() {
+        if (--m_state->depth == 0)
+            flush_deferred(*m_state);
+    }
+
+    void irq_defer_guard::flush() {
+        flush_deferred(current_defer_state());
+    }
+
     bool irq_initiator_socket::irq_state_tracker::operator = (bool state) {
         if (state == active)
             return state;
 
         active = state;
+        if (vector < IRQ_DENSE_VECTORS) {
+            if (state)
+                parent->m_dense |= 1ull << vector;
+            else
+                parent->m_dense &= ~(1ull << vector);
+        }
+
         parent->irq_transport(*this);
         return active;
     }
@@ -87,8 +151,13 @@ namespace vcml {
         irq_base_initiator_socket(nm, as),
         m_parent(hierarchy_search<module>()),
         m_host(dynamic_cast<irq_target*>(hierarchy_top())),
-        m_state(), m_event(nullptr), m_transport(this) {
+        m_default(), m_vectors(), m_dense(0), m_state(), m_event(nullptr),
+        m_deferred(), m_defer_list(nullptr), m_flush_ev(nullptr),
+        m_transport(this) {
         VCML_ERROR_ON(!m_parent, "%s declared outside module", name());
+        m_default.parent = this;
+        m_default.vector = IRQ_NO_VECTOR;
+        m_default.active = false;
         bind(m_transport);
         if (m_host)
             m_host->m_initiator_sockets.push_back(this);
@@ -99,6 +168,10 @@ namespace vcml {
             stl_remove_erase(m_host->m_initiator_sockets, this);
         if (m_event)
             delete m_event;
+        if (m_flush_ev)
+            delete m_flush_ev;
+        if (m_defer_list)
+            stl_remove_erase(*m_defer_list, this);
     }
 
     const sc_event& irq_initiator_socket::default_event() {
@@ -111,7 +184,12 @@ namespace vcml {
     }
 
     bool irq_initiator_socket::read(irq_vector vector) const {
-        return m_state.count(vector) ? m_state.at(vector) : false;
+        if (vector == IRQ_NO_VECTOR)
+            return m_default.active;
+        if (vector < IRQ_DENSE_VECTORS)
+            return (m_dense >> vector) & 1;
+        auto it = m_state.find(vector);
+        return it != m_state.end() ? it->second.active : false;
     }
 
     void irq_initiator_socket::write(bool state, irq_vector vector) {
@@ -126,21 +204,110 @@ namespace vcml {
         write(false, vector);
     }
 
+    void irq_initiator_socket::write_vectors(u64 mask, u64 values) {
+        u64 changed = mask & (m_dense ^ values);
+        while (changed) {
+            irq_vector vector = ctz(changed);
+            changed &= changed - 1;
+            (*this)[vector] = (values >> vector) & 1;
+        }
+    }
+
+    void irq_initiator_socket::write_deferred(bool state, irq_vector vector) {
+        if (!sim_running()) {
+            write(state, vector);
+            return;
+        }
+
+        bool found = false;
+        for (irq_payload& irq : m_deferred) {
+            if (irq.vector == vector) {
+                irq.active = state;
+                found = true;
+                break;
+            }
+        }
+
+        if (!found)
+            m_deferred.push_back({vector, state});
+
+        // the process writing last is responsible for flushing
+        auto list = &current_defer_state().sockets;
+        if (m_defer_list != list) {
+            if (m_defer_list)
+                stl_remove_erase(*m_defer_list, this);
+            list->push_back(this);
+            m_defer_list = list;
+        }
+
+        if (m_flush_ev == nullptr) {
+            hierarchy_guard guard(m_parent);
+            string nm = mkstr("%s_flush", basename());
+            m_flush_ev = new sc_event((nm + "_ev").c_str());
+
+            sc_spawn_options opts;
+            opts.spawn_method();
+            opts.set_sensitivity(m_flush_ev);
+            opts.dont_initialize();
+
+            sc_spawn(sc_bind(&irq_initiator_socket::flush_deferred, this),
+                     nm.c_str(), &opts);
+        }
+
+        m_flush_ev->notify(SC_ZERO_TIME);
+    }
+
+    void irq_initiator_socket::flush_deferred() {
+        if (m_defer_list) {
+            stl_remove_erase(*m_defer_list, this);
+            m_defer_list = nullptr;
+        }
+
+        if (m_flush_ev)
+            m_flush_ev->cancel();
+
+        // pop entries one by one so that the buffer is kept allocated and
+        // writes deferred while forwarding are not lost
+        while (!m_deferred.empty()) {
+            irq_payload irq = m_deferred.back();
+            m_deferred.pop_back();
+            (*this)[irq.vector] = irq.active;
+        }
+    }
+
     irq_initiator_socket& irq_initiator_socket::operator = (bool set) {
-        (*this)[IRQ_NO_VECTOR] = set;
+        m_default = set;
         return *this;
     }
 
     irq_initiator_socket::irq_state_tracker&
     irq_initiator_socket::operator [] (irq_vector vector) {
-        if (m_state.count(vector))
-            return m_state[vector];
+        if (vector == IRQ_NO_VECTOR)
+            return m_default;
+
+        if (vector < IRQ_DENSE_VECTORS) {
+            // allocate all at once, so that references remain valid
+            if (m_vectors.empty()) {
+                m_vectors.resize(IRQ_DENSE_VECTORS);
+                for (irq_vector v = 0; v < IRQ_DENSE_VECTORS; v++) {
+                    m_vectors[v].parent = this;
+                    m_vectors[v].active = false;
+                    m_vectors[v].vector = v;
+                }
+            }
+
+            return m_vectors[vector];
+        }
+
+        auto it = m_state.find(vector);
+        if (it != m_state.end())
+            return it->second;
 
-        irq_state_tracker state;
+        irq_state_tracker& state = m_state[vector];
         state.parent = this;
         state.active = false;
         state.vector = vector;
-        return m_state[vector] = state;
+        return state;
     }
 
     void irq_initiator_socket::irq_transport(irq_payload& irq) {
@@ -153,8 +320,18 @@ namespace vcml {
     }
 
     void irq_target_socket::irq_transport(irq_payload& irq) {
+        irq_defer_guard guard;
         m_parent->trace_fw(*this, irq);
-        m_state[irq.vector] = irq.active;
+
+        if (irq.vector == IRQ_NO_VECTOR)
+            m_default = irq.active;
+        else if (irq.vector >= IRQ_DENSE_VECTORS)
+            m_state[irq.vector] = irq.active;
+        else if (irq.active)
+            m_dense |= 1ull << irq.vector;
+        else
+            m_dense &= ~(1ull << irq.vector);
+
         m_host->irq_transport(*this, irq);
         m_parent->trace_bw(*this, irq);
         if (m_event)
@@ -165,7 +342,8 @@ namespace vcml {
         irq_base_target_socket(nm, _as),
         m_parent(hierarchy_search<module>()),
         m_host(hierarchy_search<irq_target>()),
-        m_state(), m_event(nullptr), m_transport(this) {
+        m_default(false), m_dense(0), m_state(), m_event(nullptr),
+        m_transport(this) {
         VCML_ERROR_ON(!m_parent, "%s declared outside module", name());
         VCML_ERROR_ON(!m_host, "%s declared outside irq_target", name());
         m_host->m_target_sockets.push_back(this);
@@ -188,7 +366,12 @@ namespace vcml {
     }
 
     bool irq_target_socket::read(irq_vector vector) const {
-        return m_state.count(vector) ? m_state.at(vector) : false;
+        if (vector == IRQ_NO_VECTOR)
+            return m_default;
+        if (vector < IRQ_DENSE_VECTORS)
+            return (m_dense >> vector) & 1;
+        auto it = m_state.find(vector);
+        return it != m_state.end() ? it->second : false;
     }
 
     irq_initiator_stub::irq_initiator_stub(const sc_module_name& nm):
@@ -18,6 +18,7 @@
 
 #include "vcml/protocols/tlm_host.h"
 #include "vcml/protocols/tlm_sockets.h"
+#include "vcml/protocols/irq.h"
 
 namespace vcml {
 
@@ -150,7 +151,10 @@ namespace vcml {
         sc_process_b* proc = current_thread();
         VCML_ERROR_ON(!proc, "b_transport outside SC_THREAD");
         m_offsets[proc] = dt;
-        transport(socket, tx, tx_get_sbi(tx));
+        {
+            irq_defer_guard guard;
+            transport(socket, tx, tx_get_sbi(tx));
+        }
         dt = m_offsets[proc];
     }
 
@@ -36,10 +36,13 @@ namespace vcml {
         m_stub(nullptr),
         m_host(hierarchy_search<tlm_host>()),
         m_parent(hierarchy_search<module>()),
-        m_adapter(nullptr) {
+        m_adapter(nullptr),
+        m_traced(false) {
         VCML_ERROR_ON(!m_host, "socket '%s' declared outside tlm_host", nm);
         VCML_ERROR_ON(!m_parent, "socket '%s' declared outside module", nm);
 
+        m_traced = m_parent->is_traced(*this);
+
         m_host->register_socket(this);
 
         register_invalidate_direct_mem_ptr(this,
@@ -122,9 +125,11 @@ namespace vcml {
             sc_time& offset = m_host->local_time();
             sc_time local = sc_time_stamp() + offset;
 
-            m_parent->trace_fw(*this, tx, offset);
+            if (m_traced)
+                m_parent->trace_fw(*this, tx, offset);
             (*this)->b_transport(tx, offset);
-            m_parent->trace_bw(*this, tx, offset);
+            if (m_traced)
+                m_parent->trace_bw(*this, tx, offset);
 
             sc_time now = sc_time_stamp() + offset;
             VCML_ERROR_ON(now < local, "b_transport time went backwards");
@@ -250,7 +255,8 @@ namespace vcml {
     }
 
     void tlm_target_socket::b_transport(tlm_generic_payload& tx, sc_time& dt) {
-        m_parent->trace_fw(*this, tx, dt);
+        if (m_traced)
+            m_parent->trace_fw(*this, tx, dt);
         // chenge this for send to any size data for once recive
         // if (tx_size(tx) > get_bus_width() / 8) {
         //     tx.set_response_status(TLM_BURST_ERROR_RESPONSE);
@@ -281,7 +287,8 @@ namespace vcml {
         m_curr++;
         m_free_ev.notify();
 
-        m_parent->trace_bw(*this, tx, dt);
+        if (m_traced)
+            m_parent->trace_bw(*this, tx, dt);
     }
 
     unsigned int tlm_target_socket::transport_dbg(tlm_generic_payload& tx) {
@@ -317,9 +324,12 @@ namespace vcml {
         m_host(hierarchy_search<tlm_host>()),
         m_parent(hierarchy_search<module>()),
         m_adapter(nullptr),
+        m_traced(false),
         as(a) {
         VCML_ERROR_ON(!m_host, "socket '%s' declared outside module", nm);
 
+        m_traced = m_parent != nullptr && m_parent->is_traced(*this);
+
         m_host->register_socket(this);
 
         register_b_transport(this, &tlm_target_socket::b_transport);
@@ -127,6 +127,15 @@ namespace vcml {
         return os;
     }
 
+#ifndef VCML_OMIT_LOGGING_SOURCE
+    void virtqueue::log_publish(log_level lvl, const char* file, int line,
+                                const char* format, ...) const {
+        va_list args; va_start(args, format);
+        logger::publish(lvl, name(), vmkstr(format, args), file, line);
+        va_end(args);
+    }
+#endif
+
     virtqueue::virtqueue(const virtio_queue_desc& desc, virtio_dmifn dmi):
         m_name(),
         id(desc.id),
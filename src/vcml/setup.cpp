@@ -27,7 +27,9 @@ namespace vcml {
         PRINT("  -l | --log [file]         Enable logging to <file>|stdout\n");
         PRINT("       --log-debug          Activate debug logging\n");
         PRINT("       --log-delta          Include delta cycle in logs\n");
+        PRINT("       --log-async          Write logs from a writer thread\n");
         PRINT("  -t | --trace [file]       Enable tracing to <file>|stdout\n");
+        PRINT("       --trace-bin <file>   Enable binary tracing to <file>\n");
         PRINT("  -f | --config-file <file> Read configuration from <file>\n");
         PRINT("  -c | --config  <x>=<y>    Set property <x> to value <y>\n");
         PRINT("  -h | --help               Print this message\n");
@@ -48,6 +50,9 @@ namespace vcml {
             } else if (!strcmp(arg, "--log-delta")) {
                 logger::print_delta_cycle = !logger::print_delta_cycle;
 
+            } else if (!strcmp(arg, "--log-async")) {
+                m_log_async = !m_log_async;
+
             } else if (!strcmp(arg, "--log") || !strcmp(arg, "-l")) {
                 if (i >= argc - 1 || *argv[i+1] == '-')
                     m_log_stdout = !m_log_stdout;
@@ -60,6 +65,14 @@ namespace vcml {
                 else
                     stl_add_unique(m_trace_files, string(argv[++i]));
 
+            } else if (!strcmp(arg, "--trace-bin")) {
+                if (i >= argc - 1 || *argv[i+1] == '-') {
+                    PRINT("Error: %s expects <file> argument\n", arg);
+                    return false;
+                }
+
+                m_trace_bin_file = argv[++i];
+
             } else if (!strcmp(arg, "--config-file") || !strcmp(arg, "-f")) {
                 if (i >= argc - 1 || *argv[i+1] == '-') {
                     PRINT("Error: %s expects <file> argument\n", arg);
@@ -88,10 +101,13 @@ namespace vcml {
 #endif
         m_log_stdout(false),
         m_trace_stdout(false),
+        m_log_async(false),
         m_log_files(),
         m_trace_files(),
         m_config_files(),
+        m_trace_bin_file(),
         m_loggers(),
+        m_trace_bin(nullptr),
         m_brokers() {
         VCML_ERROR_ON(s_instance != nullptr, "setup already created");
         s_instance = this;
@@ -126,6 +142,14 @@ namespace vcml {
             m_loggers.push_back(tracer);
         }
 
+        if (m_log_async) {
+            for (auto& log : m_loggers)
+                log = new log_async(log);
+        }
+
+        if (!m_trace_bin_file.empty())
+            m_trace_bin = new trace_bin(m_trace_bin_file);
+
         m_brokers.push_back(new broker_arg(argc, argv));
         m_brokers.push_back(new broker_env());
 
@@ -140,6 +164,8 @@ namespace vcml {
             delete provider;
         for (auto logger : m_loggers)
             delete logger;
+        if (m_trace_bin != nullptr)
+            delete m_trace_bin;
     }
 
     setup* setup::instance() {
@@ -166,6 +192,8 @@ namespace vcml {
             res = EXIT_FAILURE;
         }
 
+        log_async::flush_all();
+
         // at this point sc_is_running is false and no new critical sections
         // should be entered, but we need to give those who are still waiting
         // to execute a final chance to run
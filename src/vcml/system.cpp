@@ -32,6 +32,7 @@ namespace vcml {
 
     system::system(const sc_module_name& nm):
         module(nm),
+        m_gdb(nullptr),
         name("name", progname()),
         desc("desc", progname()),
         config("config", ""),
@@ -39,7 +40,10 @@ namespace vcml {
         session("session", -1),
         session_debug("session_debug", false),
         quantum("quantum", sc_time(1, SC_US)),
-        duration("duration", SC_ZERO_TIME) {
+        duration("duration", SC_ZERO_TIME),
+        gdb_port("gdb_port", -1),
+        gdb_wait("gdb_wait", false),
+        gdb_echo("gdb_echo", false) {
 
         if (backtrace)
             report::report_segfaults();
@@ -52,7 +56,8 @@ namespace vcml {
     }
 
     system::~system() {
-        // nothing to do
+        if (m_gdb)
+            delete m_gdb;
     }
 
     int system::run() {
@@ -75,7 +80,59 @@ namespace vcml {
             log_info("simulation stopped");
         }
 
+        double secs = sc_time_stamp().to_seconds();
+        log_debug("simulated %s in %lu delta cycles and %lu time steps",
+                  sc_time_stamp().to_string().c_str(), sim_delta_cycles(),
+                  sim_time_steps());
+        if (secs > 0.0) {
+            log_debug("%.0f delta cycles per simulated second",
+                      sim_delta_cycles() / secs);
+        }
+
         return EXIT_SUCCESS;
     }
 
+    void system::end_of_elaboration() {
+        module::end_of_elaboration();
+
+        if (gdb_port < 0)
+            return;
+
+        // expose all debug targets sharing the architecture of the first
+        // one as threads of a single gdbserver, ordered by their names
+        vector<debugging::target*> all = debugging::target::all();
+        std::sort(all.begin(), all.end(), [](debugging::target* a,
+                                             debugging::target* b) -> bool {
+            return strcmp(a->target_name(), b->target_name()) < 0;
+        });
+
+        vector<debugging::target*> targets;
+        for (debugging::target* tgt : all) {
+            const char* arch = targets.empty() ? tgt->arch()
+                                               : targets[0]->arch();
+            if (!strcmp(tgt->arch(), arch) && debugging::gdbarch::lookup(arch))
+                targets.push_back(tgt);
+            else
+                log_warn("skipping gdb target %s", tgt->target_name());
+        }
+
+        if (targets.empty()) {
+            log_warn("no debug targets found for gdbserver");
+            return;
+        }
+
+        debugging::gdb_status status = gdb_wait ? debugging::GDB_STOPPED
+                                                : debugging::GDB_RUNNING;
+
+        m_gdb = new debugging::gdbserver(gdb_port, targets, status);
+        m_gdb->echo(gdb_echo);
+
+        if (gdb_port == 0)
+            gdb_port = m_gdb->port();
+
+        log_info("%s for GDB connection on port %hu with %zu threads",
+                 gdb_wait ? "waiting" : "listening", m_gdb->port(),
+                 targets.size());
+    }
+
 }
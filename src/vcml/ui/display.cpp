@@ -34,7 +34,8 @@ namespace vcml { namespace ui {
         m_dispno(nr),
         m_mode(),
         m_fb(nullptr),
-        m_nullfb(nullptr) {
+        m_nullfb(nullptr),
+        m_fbres(true) {
     }
 
     display::~display() {
@@ -45,6 +46,8 @@ namespace vcml { namespace ui {
         if (has_framebuffer())
             shutdown();
 
+        thctl_exclusive_guard guard(m_fbres);
+
         m_mode = mode;
         m_fb = fbptr;
 
@@ -57,6 +60,7 @@ namespace vcml { namespace ui {
     }
 
     void display::shutdown() {
+        thctl_exclusive_guard guard(m_fbres);
         if (m_nullfb)
             delete [] m_nullfb;
         m_fb = m_nullfb = nullptr;
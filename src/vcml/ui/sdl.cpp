@@ -323,14 +323,16 @@ namespace vcml { namespace ui {
         rect.w = disp->resx();
         rect.h = disp->resy();
 
-        int pitch = disp->framebuffer_size() / disp->resy();
-        const void* pixels = disp->framebuffer();
-
         SDL_RenderClear(renderer);
 
-        if (pixels) {
-            SDL_UpdateTexture(texture, &rect, pixels, pitch);
-            SDL_RenderCopy(renderer, texture, nullptr, nullptr);
+        {
+            thctl_shared_guard guard(disp->framebuffer_resource());
+            int pitch = disp->framebuffer_size() / disp->resy();
+            const void* pixels = disp->framebuffer();
+            if (pixels) {
+                SDL_UpdateTexture(texture, &rect, pixels, pitch);
+                SDL_RenderCopy(renderer, texture, nullptr, nullptr);
+            }
         }
 
         SDL_RenderPresent(renderer);
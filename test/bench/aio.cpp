@@ -0,0 +1,125 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "testing.h"
+
+#include <chrono>
+#include <sys/resource.h>
+
+class aio_bench
+{
+public:
+    enum : size_t {
+        NUM_PIPES = 1000,
+        NUM_ROUNDS = 100,
+    };
+
+    struct endpoint {
+        int rd;
+        int wr;
+    };
+
+    vector<endpoint> pipes;
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    size_t handled;
+
+    std::chrono::steady_clock::time_point sent;
+    double latency;
+
+    aio_bench(): pipes(), mtx(), cv(), handled(0), sent(), latency(0.0) {
+        for (size_t i = 0; i < NUM_PIPES; i++) {
+            int fds[2];
+            if (pipe(fds) < 0)
+                break;
+            pipes.push_back({fds[0], fds[1]});
+        }
+    }
+
+    ~aio_bench() {
+        for (auto& p : pipes) {
+            aio_cancel(p.rd);
+            close(p.rd);
+            close(p.wr);
+        }
+    }
+
+    void handle(int fd) {
+        char buf;
+        EXPECT_EQ(read(fd, &buf, 1), 1);
+
+        auto now = std::chrono::steady_clock::now();
+
+        std::lock_guard<std::mutex> guard(mtx);
+        std::chrono::duration<double, std::micro> us = now - sent;
+        latency += us.count();
+        handled++;
+        cv.notify_all();
+    }
+
+    void wait(size_t count) {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [&]() -> bool { return handled >= count; });
+    }
+};
+
+TEST(aio, pipes) {
+    struct rlimit rl;
+    ASSERT_EQ(getrlimit(RLIMIT_NOFILE, &rl), 0);
+    if (rl.rlim_cur < 2 * aio_bench::NUM_PIPES + 64) {
+        rl.rlim_cur = min<rlim_t>(rl.rlim_max, 2 * aio_bench::NUM_PIPES + 64);
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+
+    aio_bench bench;
+    ASSERT_EQ(bench.pipes.size(), aio_bench::NUM_PIPES)
+        << "cannot open enough file descriptors";
+
+    // wakeup latency: every pipe becomes readable right after registration
+    size_t expected = 0;
+    for (auto& p : bench.pipes) {
+        aio_notify(p.rd, [&](int fd) -> void { bench.handle(fd); });
+        {
+            std::lock_guard<std::mutex> guard(bench.mtx);
+            bench.sent = std::chrono::steady_clock::now();
+        }
+
+        EXPECT_EQ(write(p.wr, "x", 1), 1);
+        bench.wait(++expected);
+    }
+
+    double latency = bench.latency / bench.pipes.size();
+    printf("aio wakeup latency after registration: %.1f us\n", latency);
+    EXPECT_LT(latency, 10000.0);
+
+    // throughput: all pipes become readable at once
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < aio_bench::NUM_ROUNDS; round++) {
+        for (auto& p : bench.pipes)
+            EXPECT_EQ(write(p.wr, "x", 1), 1);
+        expected += bench.pipes.size();
+        bench.wait(expected);
+    }
+
+    auto t1 = std::chrono::steady_clock::now();
+    std::chrono::duration<double> secs = t1 - t0;
+    double events = aio_bench::NUM_ROUNDS * bench.pipes.size();
+    printf("aio throughput with %zu pipes: %.0f events/s\n",
+           bench.pipes.size(), events / secs.count());
+}
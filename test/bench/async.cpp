@@ -0,0 +1,78 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "testing.h"
+
+#include <chrono>
+
+class async_bench: public test_base
+{
+public:
+    enum : size_t {
+        NUM_SYNCS = 100000,
+        NUM_POSTS = 1000000,
+    };
+
+    size_t count;
+
+    async_bench(const sc_module_name& nm):
+        test_base(nm), count(0) {
+    }
+
+    template <typename FUNC>
+    double measure(FUNC func) {
+        auto t0 = std::chrono::steady_clock::now();
+        sc_async(func);
+        auto t1 = std::chrono::steady_clock::now();
+        std::chrono::duration<double> secs = t1 - t0;
+        return secs.count();
+    }
+
+    virtual void run_test() override {
+        double t = measure([&]() -> void {
+            for (size_t i = 0; i < NUM_SYNCS; i++)
+                sc_sync([&]() -> void { count++; });
+        });
+
+        EXPECT_EQ(count, NUM_SYNCS);
+        printf("sc_sync round-trips: %.0f/s\n", NUM_SYNCS / t);
+
+        count = 0;
+        t = measure([&]() -> void {
+            for (size_t i = 0; i < NUM_POSTS; i++)
+                sc_post([&]() -> void { count++; });
+            sc_sync([]() -> void {});
+        });
+
+        EXPECT_EQ(count, NUM_POSTS);
+        printf("sc_post jobs: %.0f/s\n", NUM_POSTS / t);
+
+        t = measure([&]() -> void {
+            for (size_t i = 0; i < NUM_SYNCS; i++)
+                sc_progress(sc_time(1, SC_NS));
+        });
+
+        EXPECT_EQ(sc_time_stamp(), sc_time(NUM_SYNCS, SC_NS));
+        printf("sc_progress updates: %.0f/s\n", NUM_SYNCS / t);
+    }
+};
+
+TEST(async, roundtrips) {
+    async_bench bench("bench");
+    sc_core::sc_start();
+}
@@ -0,0 +1,95 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+#include "testing.h"
+
+#include <chrono>
+
+class clint_bench: public test_base
+{
+public:
+    enum : size_t {
+        NUM_HARTS = 128,
+        NUM_ROUNDS = 1000,
+    };
+
+    tlm_initiator_socket OUT;
+    sc_vector<irq_target_socket> IRQ_TIMER;
+
+    size_t transitions;
+
+    clint_bench(const sc_module_name& nm):
+        test_base(nm),
+        OUT("OUT"),
+        IRQ_TIMER("IRQ_TIMER", NUM_HARTS),
+        transitions(0) {
+    }
+
+    virtual void irq_transport(const irq_target_socket& socket,
+                               irq_payload& irq) override {
+        transitions++;
+    }
+
+    virtual void run_test() override {
+        const sc_time period(1.0, SC_MS);
+        const u64 cycles = period / clock_cycle();
+
+        u64 deltas = sc_delta_count();
+        auto t0 = std::chrono::steady_clock::now();
+
+        // every hart reprograms its timer once per millisecond to a
+        // staggered deadline within that millisecond
+        for (size_t round = 0; round < NUM_ROUNDS; round++) {
+            u64 mtime = 0;
+            EXPECT_OK(OUT.readw(0xbff8, mtime));
+            for (size_t hart = 0; hart < NUM_HARTS; hart++) {
+                u64 cmp = mtime + cycles / 2 + hart * 100;
+                EXPECT_OK(OUT.writew(0x4000 + hart * 8, cmp));
+            }
+
+            wait(period);
+        }
+
+        auto t1 = std::chrono::steady_clock::now();
+        std::chrono::duration<double, std::milli> ms = t1 - t0;
+        deltas = sc_delta_count() - deltas;
+
+        for (size_t hart = 0; hart < NUM_HARTS; hart++)
+            EXPECT_TRUE(IRQ_TIMER[hart].read()) << "hart " << hart;
+
+        EXPECT_EQ(transitions, (2 * NUM_ROUNDS - 1) * NUM_HARTS);
+
+        printf("clint %d harts: %.1f ms for %d simulated ms, %lu kernel "
+               "events, %zu irq edges\n", (int)NUM_HARTS, ms.count(),
+               (int)NUM_ROUNDS, deltas, transitions);
+    }
+};
+
+TEST(clint, reprogram) {
+    clint_bench bench("bench");
+    riscv::clint clint("CLINT");
+
+    clint.CLOCK.stub(100 * MHz);
+    clint.RESET.stub();
+
+    bench.OUT.bind(clint.IN);
+
+    for (size_t hart = 0; hart < clint_bench::NUM_HARTS; hart++)
+        clint.IRQ_TIMER[hart].bind(bench.IRQ_TIMER[hart]);
+
+    sc_core::sc_start();
+}
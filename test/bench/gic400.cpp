@@ -0,0 +1,139 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+#include "testing.h"
+
+#include <chrono>
+
+class gic400_bench: public test_base
+{
+public:
+    enum : size_t {
+        NUM_SPI = 480,
+        NUM_BUSY = 64,
+        NUM_EDGES = 100000,
+    };
+
+    static const vector<unsigned int> CPUS;
+
+    static size_t first_cpu(size_t gic) {
+        size_t first = 0;
+        for (size_t i = 0; i < gic; i++)
+            first += CPUS[i];
+        return first;
+    }
+
+    sc_vector<arm::gic400> GIC;
+
+    sc_vector<tlm_initiator_socket> DISTIF_OUT;
+    sc_vector<tlm_initiator_socket> CPUIF_OUT;
+
+    sc_vector<irq_initiator_socket> SPI_OUT;
+    sc_vector<irq_target_socket> IRQ_IN;
+
+    size_t transitions;
+
+    gic400_bench(const sc_module_name& nm):
+        test_base(nm),
+        GIC("GIC", CPUS.size()),
+        DISTIF_OUT("DISTIF_OUT", CPUS.size()),
+        CPUIF_OUT("CPUIF_OUT", CPUS.size()),
+        SPI_OUT("SPI_OUT", CPUS.size() * NUM_SPI),
+        IRQ_IN("IRQ_IN", first_cpu(CPUS.size())),
+        transitions(0) {
+        for (size_t i = 0; i < CPUS.size(); i++) {
+            GIC[i].CLOCK.stub(100 * MHz);
+            GIC[i].RESET.stub();
+
+            DISTIF_OUT[i].bind(GIC[i].DISTIF.IN);
+            CPUIF_OUT[i].bind(GIC[i].CPUIF.IN);
+
+            for (size_t spi = 0; spi < NUM_SPI; spi++)
+                SPI_OUT[i * NUM_SPI + spi].bind(GIC[i].SPI_IN[spi]);
+
+            for (unsigned int cpu = 0; cpu < CPUS[i]; cpu++)
+                GIC[i].IRQ_OUT[cpu].bind(IRQ_IN[first_cpu(i) + cpu]);
+        }
+    }
+
+    virtual void irq_transport(const irq_target_socket& socket,
+                               irq_payload& irq) override {
+        transitions++;
+    }
+
+    void setup(size_t i) {
+        u32 enable = ~0u, level = 0u, ctlr = 1u, pmr = 0xff;
+        for (size_t spi = 0; spi < NUM_SPI; spi += 32)
+            ASSERT_OK(DISTIF_OUT[i].writew(0x104 + spi / 8, enable));
+        for (size_t spi = 0; spi < NUM_SPI; spi += 16)
+            ASSERT_OK(DISTIF_OUT[i].writew(0xc08 + spi / 4, level));
+
+        for (size_t spi = 0; spi < NUM_SPI; spi++) {
+            u8 target = 1 << (spi % CPUS[i]);
+            u8 prio = spi < NUM_SPI - NUM_BUSY ? 0x10 + (spi % 0xc0) : 0xf0;
+            ASSERT_OK(DISTIF_OUT[i].writew(0x820 + spi, target));
+            ASSERT_OK(DISTIF_OUT[i].writew(0x420 + spi, prio));
+        }
+
+        for (unsigned int cpu = 0; cpu < CPUS[i]; cpu++) {
+            ASSERT_OK(CPUIF_OUT[i].writew(0x00, ctlr, SBI_CPUID(cpu)));
+            ASSERT_OK(CPUIF_OUT[i].writew(0x04, pmr, SBI_CPUID(cpu)));
+        }
+
+        ASSERT_OK(DISTIF_OUT[i].writew(0x000, ctlr));
+    }
+
+    double measure(size_t i) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < NUM_EDGES; n++) {
+            irq_initiator_socket& spi = SPI_OUT[i * NUM_SPI +
+                                                n % (NUM_SPI - NUM_BUSY)];
+            spi = true;
+            spi = false;
+        }
+
+        auto t1 = std::chrono::steady_clock::now();
+        std::chrono::duration<double, std::nano> ns = t1 - t0;
+        return ns.count() / (2 * NUM_EDGES);
+    }
+
+    virtual void run_test() override {
+        for (size_t i = 0; i < CPUS.size(); i++) {
+            setup(i);
+
+            transitions = 0;
+            double idle = measure(i);
+            EXPECT_EQ(transitions, 2 * NUM_EDGES);
+
+            // keep low priority irqs pending on every cpu
+            for (size_t spi = NUM_SPI - NUM_BUSY; spi < NUM_SPI; spi++)
+                SPI_OUT[i * NUM_SPI + spi] = true;
+
+            double busy = measure(i);
+
+            printf("gic400 %u cpus: %.0f ns per edge idle, %.0f ns with %d "
+                   "pending\n", CPUS[i], idle, busy, (int)NUM_BUSY);
+        }
+    }
+};
+
+const vector<unsigned int> gic400_bench::CPUS = { 1, 4, 8 };
+
+TEST(gic400, irq_latency) {
+    gic400_bench bench("bench");
+    sc_core::sc_start();
+}
@@ -0,0 +1,96 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+#include "testing.h"
+
+#include <chrono>
+
+class gpio_bench: public test_base
+{
+public:
+    enum : size_t {
+        NUM_ROUNDS = 2000,
+        NLINES = generic::gpio::NLINES,
+    };
+
+    tlm_initiator_socket OUT;
+    sc_vector<sc_signal<bool>> LINES;
+
+    gpio_bench(const sc_module_name& nm):
+        test_base(nm),
+        OUT("OUT"),
+        LINES("LINES", NLINES) {
+    }
+
+    // toggle every line once per round, one line per register write
+    double measure_lines() {
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < NUM_ROUNDS; n++) {
+            for (size_t line = 0; line < NLINES; line++) {
+                u64 addr = 0x60 + line / 32 * 4;
+                EXPECT_OK(OUT.writew<u32>(addr, 1u << (line % 32)));
+            }
+
+            wait(SC_ZERO_TIME);
+        }
+
+        auto t1 = std::chrono::steady_clock::now();
+        std::chrono::duration<double, std::nano> ns = t1 - t0;
+        return ns.count() / (NUM_ROUNDS * NLINES);
+    }
+
+    // toggle every line once per round, 64 lines per register write
+    double measure_ports() {
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < NUM_ROUNDS; n++) {
+            for (u64 addr = 0x60; addr < 0x80; addr += 8)
+                EXPECT_OK(OUT.writew<u64>(addr, ~0ull));
+
+            wait(SC_ZERO_TIME);
+        }
+
+        auto t1 = std::chrono::steady_clock::now();
+        std::chrono::duration<double, std::nano> ns = t1 - t0;
+        return ns.count() / (NUM_ROUNDS * NLINES);
+    }
+
+    virtual void run_test() override {
+        double lines = measure_lines();
+        double ports = measure_ports();
+
+        wait(SC_ZERO_TIME);
+        for (size_t line = 0; line < NLINES; line++)
+            EXPECT_FALSE(LINES[line].read()) << "GPIO" << line << " set";
+
+        printf("gpio: %.1f ns per line toggle with single line writes, "
+               "%.1f ns with 64bit port writes\n", lines, ports);
+    }
+};
+
+TEST(gpio, bench) {
+    gpio_bench bench("BENCH");
+    generic::gpio gpio("GPIO");
+
+    gpio.CLOCK.stub(100 * MHz);
+    gpio.RESET.stub();
+
+    bench.OUT.bind(gpio.IN);
+    for (size_t idx = 0; idx < gpio_bench::NLINES; idx++)
+        gpio.GPIO[idx].bind(bench.LINES[idx]);
+
+    sc_core::sc_start();
+}
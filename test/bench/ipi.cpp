@@ -0,0 +1,130 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+#include "testing.h"
+
+#include <chrono>
+
+class ipi_bench: public test_base
+{
+public:
+    enum : size_t {
+        NUM_CPUS = 8,
+        NUM_ROUNDS = 50000,
+    };
+
+    arm::gic400 GIC;
+    opencores::ompic OMPIC;
+
+    tlm_initiator_socket DISTIF_OUT;
+    tlm_initiator_socket CPUIF_OUT;
+    tlm_initiator_socket OMPIC_OUT;
+
+    sc_vector<irq_target_socket> GIC_IRQ;
+    sc_vector<irq_target_socket> OMPIC_IRQ;
+
+    size_t transitions;
+
+    ipi_bench(const sc_module_name& nm):
+        test_base(nm),
+        GIC("GIC"),
+        OMPIC("OMPIC", NUM_CPUS),
+        DISTIF_OUT("DISTIF_OUT"),
+        CPUIF_OUT("CPUIF_OUT"),
+        OMPIC_OUT("OMPIC_OUT"),
+        GIC_IRQ("GIC_IRQ", NUM_CPUS),
+        OMPIC_IRQ("OMPIC_IRQ", NUM_CPUS),
+        transitions(0) {
+        GIC.CLOCK.stub(100 * MHz);
+        GIC.RESET.stub();
+        OMPIC.CLOCK.stub(100 * MHz);
+        OMPIC.RESET.stub();
+
+        DISTIF_OUT.bind(GIC.DISTIF.IN);
+        CPUIF_OUT.bind(GIC.CPUIF.IN);
+        OMPIC_OUT.bind(OMPIC.IN);
+
+        for (size_t cpu = 0; cpu < NUM_CPUS; cpu++) {
+            GIC.IRQ_OUT[cpu].bind(GIC_IRQ[cpu]);
+            OMPIC.IRQ[cpu].bind(OMPIC_IRQ[cpu]);
+        }
+    }
+
+    virtual void irq_transport(const irq_target_socket& socket,
+                               irq_payload& irq) override {
+        transitions++;
+    }
+
+    // cpu 'src' sends sgi to 'dst', which acknowledges and completes it
+    void gic_ping(unsigned int src, unsigned int dst, u32 sgi) {
+        u32 sgir = 1u << (16 + dst) | sgi, iar = 0;
+        ASSERT_OK(DISTIF_OUT.writew(0xf00, sgir, SBI_CPUID(src)));
+        ASSERT_TRUE(GIC_IRQ[dst].read()) << "sgi not delivered";
+        ASSERT_OK(CPUIF_OUT.readw(0x0c, iar, SBI_CPUID(dst)));
+        ASSERT_EQ(iar & 0x3ff, sgi) << "wrong sgi acknowledged";
+        ASSERT_OK(CPUIF_OUT.writew(0x10, iar, SBI_CPUID(dst)));
+        ASSERT_FALSE(GIC_IRQ[dst].read()) << "sgi still pending";
+    }
+
+    void ompic_ping(unsigned int src, unsigned int dst, u32 data) {
+        u32 gen = opencores::ompic::CTRL_IRQ_GEN | dst << 16 | data;
+        u32 ack = opencores::ompic::CTRL_IRQ_ACK | dst << 16;
+        ASSERT_OK(OMPIC_OUT.writew(src * 8, gen));
+        ASSERT_TRUE(OMPIC_IRQ[dst].read()) << "ipi not delivered";
+        ASSERT_OK(OMPIC_OUT.writew(dst * 8, ack));
+        ASSERT_FALSE(OMPIC_IRQ[dst].read()) << "ipi still pending";
+    }
+
+    template <typename FUNC>
+    void measure(const char* what, FUNC ping) {
+        transitions = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < NUM_ROUNDS; n++) {
+            ping(0, 1, n % 16);
+            ping(1, 0, n % 16);
+        }
+
+        auto t1 = std::chrono::steady_clock::now();
+        std::chrono::duration<double, std::nano> ns = t1 - t0;
+
+        // only the target cpu output toggles, twice per ping
+        EXPECT_EQ(transitions, 4 * NUM_ROUNDS) << what;
+        printf("%s ipi ping-pong: %.0f ns per round trip\n", what,
+               ns.count() / NUM_ROUNDS);
+    }
+
+    virtual void run_test() override {
+        ASSERT_OK(DISTIF_OUT.writew(0x000, 1u));
+        for (unsigned int cpu = 0; cpu < NUM_CPUS; cpu++) {
+            ASSERT_OK(CPUIF_OUT.writew(0x00, 1u, SBI_CPUID(cpu)));
+            ASSERT_OK(CPUIF_OUT.writew(0x04, 0xffu, SBI_CPUID(cpu)));
+        }
+
+        measure("gic400", [&](unsigned int s, unsigned int d, u32 n) {
+            gic_ping(s, d, n);
+        });
+
+        measure("ompic", [&](unsigned int s, unsigned int d, u32 n) {
+            ompic_ping(s, d, n);
+        });
+    }
+};
+
+TEST(ipi, ping_pong) {
+    ipi_bench bench("bench");
+    sc_core::sc_start();
+}
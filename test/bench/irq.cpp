@@ -0,0 +1,97 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+#include "testing.h"
+
+#include <chrono>
+
+class irq_bench: public test_base
+{
+public:
+    enum : size_t {
+        NUM_TARGETS = 4,
+        NUM_EDGES = 1000000,
+    };
+
+    irq_initiator_socket OUT;
+    sc_vector<irq_target_socket> IN;
+
+    size_t transitions;
+
+    irq_bench(const sc_module_name& nm):
+        test_base(nm),
+        OUT("OUT"),
+        IN("IN", NUM_TARGETS),
+        transitions(0) {
+        for (size_t i = 0; i < NUM_TARGETS; i++)
+            OUT.bind(IN[i]);
+    }
+
+    virtual void irq_transport(const irq_target_socket& socket,
+                               irq_payload& irq) override {
+        transitions++;
+    }
+
+    template <typename FUNC>
+    void measure(const char* what, size_t expected, FUNC toggle) {
+        transitions = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < NUM_EDGES; n++)
+            toggle(n);
+        auto t1 = std::chrono::steady_clock::now();
+
+        EXPECT_EQ(transitions, expected) << what;
+
+        std::chrono::duration<double, std::nano> ns = t1 - t0;
+        printf("irq %-10s %6.1f ns per write\n", what, ns.count() / NUM_EDGES);
+    }
+
+    virtual void run_test() override {
+        measure("default", NUM_EDGES * NUM_TARGETS, [&](size_t n) -> void {
+            OUT = n & 1 ? false : true;
+        });
+
+        measure("redundant", 0, [&](size_t n) -> void {
+            OUT = false;
+        });
+
+        measure("dense", NUM_EDGES * NUM_TARGETS, [&](size_t n) -> void {
+            irq_vector vector = (n / 2) % IRQ_DENSE_VECTORS;
+            OUT[vector] = n & 1 ? false : true;
+        });
+
+        measure("sparse", NUM_EDGES * NUM_TARGETS, [&](size_t n) -> void {
+            irq_vector vector = 1000 + (n / 2) % IRQ_DENSE_VECTORS;
+            OUT[vector] = n & 1 ? false : true;
+        });
+
+        // each batch raises or lowers eight vectors at once
+        measure("batched", NUM_EDGES * NUM_TARGETS * 8, [&](size_t n) -> void {
+            u64 mask = 0xffull << (8 * ((n / 2) % 8));
+            OUT.write_vectors(mask, n & 1 ? 0 : ~0ull);
+        });
+
+        EXPECT_EQ(OUT.read_vectors(), 0);
+        for (size_t i = 0; i < NUM_TARGETS; i++)
+            EXPECT_EQ(IN[i].read_vectors(), 0);
+    }
+};
+
+TEST(irq, toggle) {
+    irq_bench bench("bench");
+    sc_core::sc_start();
+}
@@ -0,0 +1,123 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+#include "testing.h"
+
+#include <chrono>
+
+class counting_logger: public vcml::logger
+{
+public:
+    size_t count;
+
+    counting_logger(log_level lvl): vcml::logger(lvl, lvl), count(0) {}
+
+    virtual void write_log(const logmsg& msg) override {
+        count++;
+    }
+};
+
+class logging_bench: public test_base
+{
+public:
+    enum : size_t {
+        NUM_CALLS = 10000000,
+    };
+
+    logging_bench(const sc_module_name& nm):
+        test_base(nm) {
+    }
+
+    template <typename FUNC>
+    double measure(FUNC func) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < NUM_CALLS; i++)
+            func(i);
+        auto t1 = std::chrono::steady_clock::now();
+        std::chrono::duration<double, std::nano> ns = t1 - t0;
+        return ns.count() / NUM_CALLS;
+    }
+
+    virtual void run_test() override {
+        double t;
+
+        // no logger listens for debug messages
+        loglvl = LOG_DEBUG;
+        t = measure([this](size_t i) -> void {
+            log_debug("suppressed message %zu", i);
+        });
+        printf("module log_debug, no listener:     %5.2f ns\n", t);
+
+        t = measure([](size_t i) -> void {
+            vcml::log_debug("suppressed message %zu", i);
+        });
+        printf("global log_debug, no listener:     %5.2f ns\n", t);
+
+        // a debug logger exists, but this module only logs up to info
+        counting_logger debug(LOG_DEBUG);
+        loglvl = LOG_INFO;
+        t = measure([this](size_t i) -> void {
+            log_debug("suppressed message %zu", i);
+        });
+        printf("module log_debug, below loglvl:    %5.2f ns\n", t);
+
+        EXPECT_EQ(debug.count, 0);
+
+        loglvl = LOG_DEBUG;
+        log_debug("this message gets logged");
+        EXPECT_EQ(debug.count, 1);
+    }
+};
+
+TEST(logging, suppressed) {
+    logging_bench bench("bench");
+    sc_core::sc_start();
+}
+
+static double log_to_file(size_t count) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++)
+        vcml::log_debug("heavy debug logging message %zu", i);
+    auto t1 = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::nano> ns = t1 - t0;
+    return ns.count() / count;
+}
+
+TEST(logging, async_file) {
+    const size_t count = 1000000;
+    string path = mkstr("/tmp/vcml_bench_log_%d.txt", (int)getpid());
+    double sync, async;
+
+    {
+        log_file logger(path);
+        logger.set_level(LOG_DEBUG);
+        sync = log_to_file(count);
+    }
+
+    {
+        log_async logger(new log_file(path), 64 * KiB);
+        logger.set_level(LOG_DEBUG);
+        async = log_to_file(count);
+        logger.flush();
+        EXPECT_EQ(logger.dropped(), 0);
+    }
+
+    printf("debug logging to file, synchronous:  %5.2f ns\n", sync);
+    printf("debug logging to file, asynchronous: %5.2f ns\n", async);
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,97 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+#include "testing.h"
+
+#include <chrono>
+
+class pl190vic_bench: public test_base
+{
+public:
+    enum : size_t {
+        NUM_ENTRIES = 200000,
+        NUM_BUSY = 8, // low priority sources kept pending
+    };
+
+    tlm_initiator_socket OUT;
+
+    sc_vector<irq_initiator_socket> IRQ_OUT;
+    irq_target_socket IRQ_IN;
+
+    pl190vic_bench(const sc_module_name& nm):
+        test_base(nm),
+        OUT("OUT"),
+        IRQ_OUT("IRQ_OUT", VCML_ARM_PL190VIC_NIRQ),
+        IRQ_IN("IRQ_IN") {
+    }
+
+    // raise a source and fetch its vector, like an irq handler entry
+    double measure(size_t nsrc) {
+        u32 addr = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < NUM_ENTRIES; n++) {
+            size_t src = n % nsrc;
+            IRQ_OUT[src] = true;
+            EXPECT_OK(OUT.readw(0x030, addr));
+            IRQ_OUT[src] = false;
+        }
+
+        auto t1 = std::chrono::steady_clock::now();
+        EXPECT_EQ(addr, 0x1000 + (NUM_ENTRIES - 1) % nsrc * 0x100);
+
+        std::chrono::duration<double, std::nano> ns = t1 - t0;
+        return ns.count() / NUM_ENTRIES;
+    }
+
+    virtual void run_test() override {
+        const u32 nvec = VCML_ARM_PL190VIC_NVEC;
+        for (u32 slot = 0; slot < nvec; slot++) {
+            u32 vaddr = 0x1000 + slot * 0x100;
+            u32 vctrl = arm::pl190vic::VCTRL_ENABLED | slot;
+            ASSERT_OK(OUT.writew(0x100 + slot * 4, vaddr));
+            ASSERT_OK(OUT.writew(0x200 + slot * 4, vctrl));
+        }
+
+        ASSERT_OK(OUT.writew(0x010, ~0u));
+
+        double idle = measure(nvec - NUM_BUSY);
+
+        for (u32 src = nvec - NUM_BUSY; src < nvec; src++)
+            IRQ_OUT[src] = true;
+
+        double busy = measure(nvec - NUM_BUSY);
+
+        printf("pl190vic: %.0f ns per irq entry idle, %.0f ns with %d "
+               "pending\n", idle, busy, (int)NUM_BUSY);
+    }
+};
+
+TEST(pl190vic, irq_entry) {
+    pl190vic_bench bench("bench");
+    arm::pl190vic vic("VIC");
+
+    vic.CLOCK.stub(100 * MHz);
+    vic.RESET.stub();
+
+    bench.OUT.bind(vic.IN);
+    vic.IRQ_OUT[0].bind(bench.IRQ_IN);
+
+    for (size_t irq = 0; irq < VCML_ARM_PL190VIC_NIRQ; irq++)
+        bench.IRQ_OUT[irq].bind(vic.IRQ_IN[irq]);
+
+    sc_core::sc_start();
+}
@@ -0,0 +1,141 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+#include "testing.h"
+
+#include <chrono>
+
+class plic_bench: public test_base
+{
+public:
+    enum : size_t {
+        NUM_SOURCES = 1023,
+        NUM_CONTEXTS = 32,
+        NUM_BUSY = 64,
+        NUM_EDGES = 100000,
+        NUM_CLAIMS = 20000,
+    };
+
+    tlm_initiator_socket OUT;
+
+    sc_vector<irq_initiator_socket> IRQS;
+    sc_vector<irq_target_socket> IRQT;
+
+    size_t transitions;
+
+    plic_bench(const sc_module_name& nm):
+        test_base(nm),
+        OUT("OUT"),
+        IRQS("IRQS", NUM_SOURCES),
+        IRQT("IRQT", NUM_CONTEXTS),
+        transitions(0) {
+    }
+
+    virtual void irq_transport(const irq_target_socket& socket,
+                               irq_payload& irq) override {
+        transitions++;
+    }
+
+    void setup() {
+        for (size_t irq = 1; irq <= NUM_SOURCES; irq++) {
+            u32 prio = irq > NUM_SOURCES - NUM_BUSY ? 1 : 2 + irq % 6;
+            ASSERT_OK(OUT.writew(irq * 4, prio));
+        }
+
+        for (size_t ctx = 0; ctx < NUM_CONTEXTS; ctx++) {
+            for (size_t word = 0; word < 32; word++)
+                ASSERT_OK(OUT.writew(0x2000 + (ctx * 32 + word) * 4, ~0u));
+            ASSERT_OK(OUT.writew(0x200000 + ctx * 0x1000, 0u));
+        }
+    }
+
+    double measure_edges() {
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < NUM_EDGES; n++) {
+            irq_initiator_socket& irq = IRQS[n % (NUM_SOURCES - NUM_BUSY)];
+            irq = true;
+            irq = false;
+        }
+
+        auto t1 = std::chrono::steady_clock::now();
+        std::chrono::duration<double, std::nano> ns = t1 - t0;
+        return ns.count() / (2 * NUM_EDGES);
+    }
+
+    double measure_claims() {
+        size_t claimed = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < NUM_CLAIMS; n++) {
+            size_t ctx = n % NUM_CONTEXTS;
+            irq_initiator_socket& irq = IRQS[n % (NUM_SOURCES - NUM_BUSY)];
+            irq = true;
+
+            u32 id = 0;
+            EXPECT_OK(OUT.readw(0x200004 + ctx * 0x1000, id));
+            irq = false;
+            EXPECT_OK(OUT.writew(0x200004 + ctx * 0x1000, id));
+            claimed += id > 0 ? 1 : 0;
+        }
+
+        auto t1 = std::chrono::steady_clock::now();
+        EXPECT_EQ(claimed, NUM_CLAIMS);
+
+        std::chrono::duration<double, std::nano> ns = t1 - t0;
+        return ns.count() / NUM_CLAIMS;
+    }
+
+    virtual void run_test() override {
+        setup();
+
+        transitions = 0;
+        double idle = measure_edges();
+        EXPECT_EQ(transitions, 2 * NUM_CONTEXTS * NUM_EDGES);
+
+        // keep low priority irqs pending on every context
+        for (size_t irq = NUM_SOURCES - NUM_BUSY; irq < NUM_SOURCES; irq++)
+            IRQS[irq] = true;
+
+        transitions = 0;
+        double busy = measure_edges();
+        EXPECT_EQ(transitions, 0);
+
+        double claim = measure_claims();
+
+        printf("plic %d sources, %d contexts: %.0f ns per edge idle, "
+               "%.0f ns with %d pending, %.0f ns per claim/complete\n",
+               (int)NUM_SOURCES, (int)NUM_CONTEXTS, idle, busy,
+               (int)NUM_BUSY, claim);
+    }
+};
+
+TEST(plic, irq_latency) {
+    plic_bench bench("bench");
+    riscv::plic plic("PLIC");
+
+    plic.CLOCK.stub(100 * MHz);
+    plic.RESET.stub();
+
+    bench.OUT.bind(plic.IN);
+
+    for (size_t i = 0; i < plic_bench::NUM_SOURCES; i++)
+        bench.IRQS[i].bind(plic.IRQS[i + 1]);
+
+    for (size_t ctx = 0; ctx < plic_bench::NUM_CONTEXTS; ctx++)
+        plic.IRQT[ctx].bind(bench.IRQT[ctx]);
+
+    sc_core::sc_start();
+}
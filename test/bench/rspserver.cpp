@@ -0,0 +1,116 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "testing.h"
+
+#include <chrono>
+
+class mem_server: public vcml::debugging::rspserver
+{
+public:
+    vector<u8> memory;
+
+    mem_server(): rspserver(0), memory(64 * KiB) {
+        for (size_t i = 0; i < memory.size(); i++)
+            memory[i] = (u8)i;
+        run_async();
+    }
+
+    virtual ~mem_server() {
+        shutdown();
+    }
+
+    virtual string handle_command(const string& command) override {
+        unsigned long long addr, size;
+        if (sscanf(command.c_str(), "m%llx,%llx", &addr, &size) != 2)
+            return "";
+
+        string result;
+        result.reserve(2 * size);
+        for (size_t n = 0; n < size; n++)
+            hex_encode(result, &memory[(addr + n) % memory.size()], 1);
+        return result;
+    }
+};
+
+static void send_command(vcml::socket& sock, const string& command) {
+    u8 sum = 0;
+    for (char c : command)
+        sum += (u8)c;
+    sock.send(mkstr("$%s#%02hhx", command.c_str(), sum));
+}
+
+static string recv_reply(vcml::socket& sock, bool noack) {
+    string reply;
+    while (sock.recv_char() != '$')
+        ; // skip acks
+
+    for (char c = sock.recv_char(); c != '#'; c = sock.recv_char())
+        reply += c;
+
+    sock.recv_char(); // checksum
+    sock.recv_char();
+
+    if (!noack)
+        sock.send_char('+');
+
+    return reply;
+}
+
+static double pull_memory(vcml::socket& sock, size_t total, size_t chunk,
+                          bool noack) {
+    auto t0 = std::chrono::steady_clock::now();
+
+    for (size_t addr = 0; addr < total; addr += chunk) {
+        send_command(sock, mkstr("m%zx,%zx", addr, chunk));
+        string reply = recv_reply(sock, noack);
+        if (reply.length() != 2 * chunk) {
+            ADD_FAILURE() << "short reply at address " << addr;
+            return 0.0;
+        }
+    }
+
+    auto t1 = std::chrono::steady_clock::now();
+    std::chrono::duration<double> secs = t1 - t0;
+    return (double)total / MiB / secs.count();
+}
+
+TEST(rspserver, memory_throughput) {
+    const size_t total = 64 * MiB;
+    const size_t chunk = 4 * KiB;
+
+    mem_server server;
+    vcml::socket client("127.0.0.1", server.port());
+
+    send_command(client, "m10,4");
+    EXPECT_EQ(recv_reply(client, false), "10111213");
+
+    double ack = pull_memory(client, total, chunk, false);
+    printf("ack mode:   %.1f MiB/s\n", ack);
+
+    send_command(client, "QStartNoAckMode");
+    EXPECT_EQ(recv_reply(client, false), "OK");
+
+    double noack = pull_memory(client, total, chunk, true);
+    printf("noack mode: %.1f MiB/s\n", noack);
+
+    EXPECT_GT(ack, 0.0);
+    EXPECT_GT(noack, 0.0);
+
+    server.shutdown();
+}
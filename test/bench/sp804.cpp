@@ -0,0 +1,134 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+#include "testing.h"
+
+#include <chrono>
+
+class sp804_bench: public test_base
+{
+public:
+    enum : size_t {
+        NUM_TIMERS = 16,
+        PERIOD = 1000, // 1kHz at 1MHz timer clock
+    };
+
+    enum : u64 {
+        TIMER1_LOAD = 0x00,
+        TIMER1_CONTROL = 0x08,
+        TIMER1_INTCLR = 0x0c,
+        TIMER2_LOAD = 0x20,
+        TIMER2_CONTROL = 0x28,
+        TIMER2_INTCLR = 0x2c,
+    };
+
+    sc_vector<arm::sp804timer> SP804;
+    sc_vector<tlm_initiator_socket> OUT;
+    sc_vector<irq_target_socket> IRQ;
+
+    size_t transitions;
+
+    sp804_bench(const sc_module_name& nm):
+        test_base(nm),
+        SP804("SP804", NUM_TIMERS),
+        OUT("OUT", NUM_TIMERS),
+        IRQ("IRQ", NUM_TIMERS),
+        transitions(0) {
+        for (size_t i = 0; i < NUM_TIMERS; i++) {
+            SP804[i].CLOCK.stub(1 * MHz);
+            SP804[i].RESET.stub();
+            SP804[i].IRQ1.stub();
+            SP804[i].IRQ2.stub();
+            SP804[i].IRQC.bind(IRQ[i]);
+            OUT[i].bind(SP804[i].IN);
+        }
+    }
+
+    virtual void irq_transport(const irq_target_socket& socket,
+                               irq_payload& irq) override {
+        transitions++;
+    }
+
+    void control(u32 val) {
+        for (size_t i = 0; i < NUM_TIMERS; i++) {
+            ASSERT_OK(OUT[i].writew(TIMER1_CONTROL, val));
+            ASSERT_OK(OUT[i].writew(TIMER2_CONTROL, val));
+        }
+    }
+
+    u64 measure(const char* what, bool service) {
+        sc_time end = sc_time_stamp() + sc_time(1.0, SC_SEC);
+        transitions = 0;
+
+        u64 deltas = sc_delta_count();
+        auto t0 = std::chrono::steady_clock::now();
+
+        if (!service) {
+            wait(end - sc_time_stamp());
+        } else {
+            while (sc_time_stamp() < end) {
+                if (IRQ[0].read()) {
+                    EXPECT_OK(OUT[0].writew(TIMER1_INTCLR, 1u));
+                    EXPECT_OK(OUT[0].writew(TIMER2_INTCLR, 1u));
+                }
+
+                wait(end - sc_time_stamp(), IRQ[0].default_event());
+            }
+        }
+
+        auto t1 = std::chrono::steady_clock::now();
+        std::chrono::duration<double, std::milli> ms = t1 - t0;
+        deltas = sc_delta_count() - deltas;
+
+        printf("sp804 %-8s %lu kernel events per simulated second, "
+               "%zu irq edges, %.1f ms\n", what, deltas, transitions,
+               ms.count());
+        return deltas;
+    }
+
+    virtual void run_test() override {
+        const u32 periodic = arm::sp804timer::timer::CONTROL_ENABLED |
+                             arm::sp804timer::timer::CONTROL_PERIOD  |
+                             arm::sp804timer::timer::CONTROL_32BIT;
+        const u32 irqen = arm::sp804timer::timer::CONTROL_IRQEN;
+
+        IRQ[0].default_event(); // needed for servicing below
+
+        for (size_t i = 0; i < NUM_TIMERS; i++) {
+            ASSERT_OK(OUT[i].writew(TIMER1_LOAD, (u32)PERIOD));
+            ASSERT_OK(OUT[i].writew(TIMER2_LOAD, (u32)PERIOD));
+        }
+
+        control(periodic);
+        EXPECT_LT(measure("masked", false), 10);
+        EXPECT_EQ(transitions, 0);
+
+        control(periodic | irqen);
+        EXPECT_LT(measure("pending", false), 10);
+        EXPECT_EQ(transitions, NUM_TIMERS);
+
+        // both counters of SP804[0] share a single wakeup per period
+        u64 serviced = measure("serviced", true);
+        EXPECT_LT(serviced, 8 * PERIOD);
+        EXPECT_NEAR(transitions, 2 * PERIOD, 2);
+    }
+};
+
+TEST(sp804, kernel_events) {
+    sp804_bench bench("bench");
+    sc_core::sc_start();
+}
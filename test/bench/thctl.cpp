@@ -0,0 +1,99 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "testing.h"
+
+#include <chrono>
+
+class thctl_bench: public test_base
+{
+public:
+    enum : size_t {
+        NUM_THREADS = 8,
+        NUM_STEPS = 20000,
+        FB_SIZE = 64 * KiB,
+    };
+
+    vector<u8> framebuffer;
+    thctl_resource fbres;
+    thctl_resource private_res;
+
+    atomic<bool> running;
+    atomic<u64> inspections;
+
+    thctl_bench(const sc_module_name& nm):
+        test_base(nm),
+        framebuffer(FB_SIZE),
+        fbres(true),
+        private_res(),
+        running(false),
+        inspections(0) {
+    }
+
+    template <typename GUARD, typename... ARGS>
+    void inspect(ARGS&... args) {
+        vector<u8> copy(FB_SIZE);
+        while (running) {
+            GUARD guard(args...);
+            memcpy(copy.data(), framebuffer.data(), FB_SIZE);
+            inspections++;
+        }
+    }
+
+    template <typename GUARD, typename... ARGS>
+    void measure(const char* desc, ARGS&... args) {
+        running = true;
+        inspections = 0;
+
+        vector<std::thread> threads;
+        for (size_t i = 0; i < NUM_THREADS; i++) {
+            threads.emplace_back([&]() -> void {
+                inspect<GUARD>(args...);
+            });
+        }
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < NUM_STEPS; i++) {
+            framebuffer[i % FB_SIZE]++;
+            wait(1, SC_NS);
+        }
+
+        auto t1 = std::chrono::steady_clock::now();
+        running = false;
+        for (auto& t : threads)
+            t.join();
+
+        std::chrono::duration<double> secs = t1 - t0;
+        printf("%s: %.0f sim steps/s, %.0f inspections/s\n", desc,
+               NUM_STEPS / secs.count(), inspections / secs.count());
+        EXPECT_GT(inspections, 0);
+    }
+
+    virtual void run_test() override {
+        measure<thctl_guard>("global critical section");
+        measure<thctl_shared_guard>("shared resource guard", fbres);
+        measure<thctl_exclusive_guard>("exclusive resource guard", fbres);
+        measure<thctl_exclusive_guard>("exclusive private guard",
+                                       private_res);
+    }
+};
+
+TEST(thctl, contention) {
+    thctl_bench bench("bench");
+    sc_core::sc_start();
+}
@@ -0,0 +1,109 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+#include "testing.h"
+
+#include <chrono>
+
+class timer_bench: public test_base
+{
+public:
+    enum : size_t {
+        NUM_TIMERS = 100000,
+        NUM_OPS = 1000000,
+    };
+
+    u64 seed;
+    size_t fired;
+    vector<timer*> timers;
+
+    u64 random() {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        return seed >> 33;
+    }
+
+    sc_time random_delay() {
+        return sc_time(1 + random() % 1000000, SC_NS);
+    }
+
+    timer_bench(const sc_module_name& nm):
+        test_base(nm), seed(42), fired(0), timers() {
+    }
+
+    virtual ~timer_bench() {
+        for (timer* t : timers)
+            delete t;
+    }
+
+    template <typename FUNC>
+    double measure(FUNC func) {
+        auto t0 = std::chrono::steady_clock::now();
+        func();
+        auto t1 = std::chrono::steady_clock::now();
+        std::chrono::duration<double> secs = t1 - t0;
+        return secs.count();
+    }
+
+    virtual void run_test() override {
+        for (size_t i = 0; i < NUM_TIMERS; i++) {
+            timers.push_back(new timer([&](timer& t) -> void {
+                fired++;
+                t.reset(random_delay());
+            }));
+        }
+
+        double t = measure([&]() -> void {
+            for (timer* tm : timers)
+                tm->reset(random_delay());
+        });
+
+        printf("arm %zu timers: %.0f/s\n", NUM_TIMERS, NUM_TIMERS / t);
+
+        t = measure([&]() -> void {
+            for (size_t i = 0; i < NUM_OPS; i++)
+                timers[random() % NUM_TIMERS]->reset(random_delay());
+        });
+
+        printf("re-arm with %zu active: %.0f/s\n", NUM_TIMERS, NUM_OPS / t);
+
+        t = measure([&]() -> void {
+            for (size_t i = 0; i < NUM_OPS; i++) {
+                timer* tm = timers[random() % NUM_TIMERS];
+                tm->cancel();
+                tm->reset(random_delay());
+            }
+        });
+
+        printf("cancel/re-arm with %zu active: %.0f/s\n", NUM_TIMERS,
+               NUM_OPS / t);
+
+        t = measure([&]() -> void {
+            wait(10, SC_MS);
+        });
+
+        for (timer* tm : timers)
+            EXPECT_TRUE(tm->is_pending());
+
+        EXPECT_GT(fired, NUM_TIMERS);
+        printf("expire/re-arm in simulation: %.0f/s\n", fired / t);
+    }
+};
+
+TEST(timer, rearm_cancel) {
+    timer_bench bench("bench");
+    sc_core::sc_start();
+}
@@ -0,0 +1,87 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+#include "testing.h"
+
+#include <chrono>
+
+class tracing_bench: public test_base
+{
+public:
+    tlm_initiator_socket OUT;
+    tlm_target_socket IN;
+
+    enum : size_t {
+        NUM_TX = 200000,
+    };
+
+    tracing_bench(const sc_module_name& nm):
+        test_base(nm),
+        OUT("OUT"),
+        IN("IN") {
+        OUT.bind(IN);
+    }
+
+    virtual unsigned int transport(tlm_generic_payload& tx,
+        const tlm_sbi& info, address_space as) override {
+        tx.set_response_status(TLM_OK_RESPONSE);
+        return tx.get_data_length();
+    }
+
+    double measure() {
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < NUM_TX; i++) {
+            u32 data = i;
+            EXPECT_OK(OUT.writew(i * 4, data));
+        }
+
+        auto t1 = std::chrono::steady_clock::now();
+        std::chrono::duration<double, std::nano> ns = t1 - t0;
+        return ns.count() / NUM_TX;
+    }
+
+    virtual void run_test() override {
+        loglvl = LOG_TRACE;
+
+        double none = measure();
+        printf("no tracing:     %7.1f ns/tx\n", none);
+
+        string path = mkstr("/tmp/vcml_bench_trace_%d.bin", (int)getpid());
+        trace_bin* bin = new trace_bin(path);
+        double binary = measure();
+        bin->flush();
+        EXPECT_EQ(bin->records(), 4 * NUM_TX + 2);
+        delete bin;
+        remove(path.c_str());
+        printf("binary tracing: %7.1f ns/tx (+%.1f ns)\n", binary,
+               binary - none);
+
+        log_file* text = new log_file("/dev/null");
+        text->set_level(LOG_TRACE, LOG_TRACE);
+        double textual = measure();
+        delete text;
+        printf("text tracing:   %7.1f ns/tx (+%.1f ns)\n", textual,
+               textual - none);
+
+        EXPECT_LT(binary, textual);
+    }
+};
+
+TEST(tracing, overhead) {
+    tracing_bench bench("bench");
+    sc_core::sc_start();
+}
@@ -54,3 +54,76 @@ TEST(aio, callback) {
     close(fds[0]);
     close(fds[1]);
 }
+
+TEST(aio, edge) {
+    const char msg = 'X';
+
+    int fds[2];
+    EXPECT_EQ(pipe(fds), 0);
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::atomic<int> count(0);
+
+    // handler does not drain the pipe, so level triggered notification
+    // would keep calling it
+    vcml::aio_notify(fds[0], [&](int fd)-> void {
+        std::lock_guard<std::mutex> guard(mtx);
+        count++;
+        cv.notify_all();
+    }, vcml::AIO_EDGE);
+
+    EXPECT_EQ(write(fds[1], &msg, 1), 1);
+
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [&]() -> bool { return count > 0; });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(count, 1) << "edge triggered handler called repeatedly";
+
+    EXPECT_EQ(write(fds[1], &msg, 1), 1);
+
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [&]() -> bool { return count > 1; });
+    }
+
+    vcml::aio_cancel(fds[0]);
+    EXPECT_EQ(count, 2);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(aio, cancel_from_handler) {
+    const char msg = 'X';
+
+    int fds[2];
+    EXPECT_EQ(pipe(fds), 0);
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::atomic<int> count(0);
+
+    vcml::aio_notify(fds[0], [&](int fd)-> void {
+        vcml::aio_cancel(fd);
+        std::lock_guard<std::mutex> guard(mtx);
+        count++;
+        cv.notify_all();
+    });
+
+    EXPECT_EQ(write(fds[1], &msg, 1), 1);
+
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [&]() -> bool { return count > 0; });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(count, 1) << "handler called after cancelling itself";
+
+    close(fds[0]);
+    close(fds[1]);
+}
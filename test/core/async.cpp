@@ -22,9 +22,10 @@ class async_test: public test_base
 {
 public:
     bool success;
+    int posted;
 
     async_test(const sc_module_name& nm):
-       test_base(nm), success(false) {
+       test_base(nm), success(false), posted(0) {
     }
 
     void work(const sc_time& duration) {
@@ -39,8 +40,16 @@ public:
             sc_progress(step);
         }
 
+        for (int i = 0; i < 10; i++) {
+            sc_post([&, i]() -> void {
+                EXPECT_TRUE(thctl_is_sysc_thread());
+                EXPECT_EQ(posted++, i) << "posted jobs out of order";
+            });
+        }
+
         sc_sync([&]() -> void {
             EXPECT_TRUE(thctl_is_sysc_thread());
+            EXPECT_EQ(posted, 10) << "posted jobs not done before sync";
             wait(duration);
             success = true;
         });
@@ -0,0 +1,275 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "testing.h"
+
+class gdb_cpu: public processor
+{
+public:
+    u64 cycles;
+    u64 regs[35];
+    u64 reject;
+
+    gdb_cpu(const sc_module_name& nm, u64 id):
+        processor(nm, "or1k"),
+        cycles(0),
+        regs(),
+        reject(~0ull) {
+        for (u64 i = 0; i < 35; i++)
+            regs[i] = id << 8 | i;
+
+        vector<debugging::cpureg> defs;
+        for (u64 i = 0; i < 32; i++) {
+            defs.push_back(debugging::cpureg(i, mkstr("r%lu", i), 4,
+                                             VCML_ACCESS_READ_WRITE));
+        }
+
+        defs.push_back(debugging::cpureg(32, "npc", 4, VCML_ACCESS_READ_WRITE));
+        defs.push_back(debugging::cpureg(33, "sr", 4, VCML_ACCESS_READ_WRITE));
+        defs.push_back(debugging::cpureg(34, "ppc", 4, VCML_ACCESS_READ_WRITE));
+        define_cpuregs(defs);
+
+        CLOCK.stub(100 * MHz);
+        RESET.stub();
+        INSN.stub();
+        DATA.stub();
+    }
+
+    virtual u64 cycle_count() const override {
+        return cycles;
+    }
+
+    // npc walks through a 4k loop and stops at breakpoints like an iss
+    virtual void simulate(unsigned int n) override {
+        for (unsigned int i = 0; i < n; i++) {
+            cycles++;
+            regs[32] = (regs[32] + 4) & 0xfff;
+            if (is_breakpoint(regs[32])) {
+                notify_breakpoint_hit(regs[32]);
+                return;
+            }
+        }
+    }
+
+    virtual bool insert_breakpoint(u64 addr) override {
+        return addr != reject;
+    }
+
+    virtual bool remove_breakpoint(u64 addr) override {
+        return true;
+    }
+
+    virtual bool read_reg_dbg(u64 idx, u64& val) override {
+        if (idx >= 35)
+            return false;
+        val = regs[idx];
+        return true;
+    }
+
+    virtual bool write_reg_dbg(u64 idx, u64 val) override {
+        if (idx >= 35)
+            return false;
+        regs[idx] = val;
+        return true;
+    }
+};
+
+static void send_command(vcml::socket& sock, const string& command) {
+    u8 sum = 0;
+    for (char c : command)
+        sum += (u8)c;
+    sock.send(mkstr("$%s#%02hhx", command.c_str(), sum));
+}
+
+static string recv_packet(vcml::socket& sock, char start = '$') {
+    while (sock.recv_char() != start)
+        ; // skip acks
+
+    string packet;
+    for (char c = sock.recv_char(); c != '#'; c = sock.recv_char())
+        packet += c;
+
+    sock.recv_char(); // checksum
+    sock.recv_char();
+
+    if (start == '$')
+        sock.send_char('+');
+
+    return packet;
+}
+
+// returns the next reply or notification, including its '$' or '%'
+static string recv_any(vcml::socket& sock) {
+    char start = sock.recv_char();
+    while (start != '$' && start != '%')
+        start = sock.recv_char(); // skip acks
+
+    string packet(1, start);
+    for (char c = sock.recv_char(); c != '#'; c = sock.recv_char())
+        packet += c;
+
+    sock.recv_char(); // checksum
+    sock.recv_char();
+
+    if (start == '$')
+        sock.send_char('+');
+
+    return packet;
+}
+
+static string transact(vcml::socket& sock, const string& command) {
+    send_command(sock, command);
+    return recv_packet(sock);
+}
+
+class gdbserver_test: public test_base
+{
+public:
+    gdb_cpu cpu0;
+    gdb_cpu cpu1;
+
+    vcml::socket client;
+    atomic<bool> done;
+
+    gdbserver_test(const sc_module_name& nm):
+        test_base(nm),
+        cpu0("cpu0", 0),
+        cpu1("cpu1", 1),
+        client(),
+        done(false) {
+    }
+
+    // the stop may be reported before or after the vCont reply
+    void expect_stop(vcml::socket& sock) {
+        set<string> replies = { recv_any(sock), recv_any(sock) };
+        EXPECT_TRUE(stl_contains(replies, string("$OK")));
+        EXPECT_TRUE(stl_contains(replies, string("%Stop:T05thread:1;")));
+    }
+
+    void run_client(u16 port) {
+        debugging::target* t0 = debugging::target::find("test.cpu0");
+        debugging::target* t1 = debugging::target::find("test.cpu1");
+        if (t0 == nullptr || t1 == nullptr) {
+            ADD_FAILURE() << "debug targets not found";
+            done = true;
+            return;
+        }
+
+        client.connect("127.0.0.1", port);
+
+        EXPECT_EQ(transact(client, "qfThreadInfo"), "m1,2");
+        EXPECT_EQ(transact(client, "qsThreadInfo"), "l");
+        EXPECT_EQ(transact(client, "T2"), "OK");
+        EXPECT_EQ(transact(client, "T3"), "E02");
+        EXPECT_EQ(transact(client, "vCont?"), "vCont;c;C;s;S;t");
+
+        EXPECT_EQ(transact(client, "Hg2"), "OK");
+        EXPECT_EQ(transact(client, "qC"), "QC2");
+        EXPECT_EQ(transact(client, "p20"), "20010000");
+        EXPECT_EQ(transact(client, "Hg1"), "OK");
+        EXPECT_EQ(transact(client, "p20"), "20000000");
+
+        EXPECT_EQ(transact(client, "Z0,100,4;X3,220127"), "OK");
+        EXPECT_EQ(transact(client, "Z0,100,4;X4,260fff27"), "E02");
+        EXPECT_EQ(transact(client, "Z0,100,4;X1,01"), "E02");
+        EXPECT_EQ(transact(client, "z0,100,4"), "OK");
+
+        // a failed insert must not leave the breakpoint on other threads
+        cpu1.reject = 0x200;
+        EXPECT_EQ(transact(client, "Z0,200,4"), "E03");
+        EXPECT_FALSE(t0->is_breakpoint(0x200)) << "insert not rolled back";
+        EXPECT_EQ(transact(client, "z0,200,4"), "E03");
+
+        // a delete must not remove the breakpoint from some threads only
+        debugging::subscriber other;
+        EXPECT_TRUE(t1->insert_breakpoint(0x300, &other));
+        EXPECT_EQ(transact(client, "z0,300,4"), "E03");
+        EXPECT_TRUE(t1->is_breakpoint(0x300)) << "partial delete";
+        EXPECT_TRUE(t1->remove_breakpoint(0x300, &other));
+
+        send_command(client, "c");
+        client.send_char(3); // break
+        EXPECT_EQ(recv_packet(client), "T05thread:1;");
+
+        EXPECT_EQ(transact(client, "QNonStop:1"), "OK");
+        EXPECT_TRUE(t0->is_halted());
+        EXPECT_TRUE(t1->is_halted());
+
+        EXPECT_EQ(transact(client, "?"), "T05thread:1;");
+        EXPECT_EQ(transact(client, "vStopped"), "T05thread:2;");
+        EXPECT_EQ(transact(client, "vStopped"), "OK");
+
+        EXPECT_EQ(transact(client, "vCont;c:1"), "OK");
+        EXPECT_FALSE(t0->is_halted());
+        EXPECT_TRUE(t1->is_halted());
+
+        send_command(client, "vCont;t:1");
+        EXPECT_EQ(recv_packet(client, '%'), "Stop:T00thread:1;");
+        EXPECT_EQ(recv_packet(client), "OK");
+        EXPECT_TRUE(t0->is_halted());
+        EXPECT_EQ(transact(client, "vStopped"), "OK");
+
+        // cpu0 must stop right at the breakpoint, not at the quantum end
+        EXPECT_EQ(transact(client, "Z0,800,4"), "OK");
+        send_command(client, "vCont;c:1");
+        expect_stop(client);
+        EXPECT_EQ(transact(client, "vStopped"), "OK");
+        EXPECT_TRUE(t0->is_halted());
+        EXPECT_TRUE(t1->is_halted());
+        EXPECT_EQ(transact(client, "p20"), "00080000");
+        EXPECT_EQ(transact(client, "z0,800,4"), "OK");
+
+        // single steps must execute exactly one instruction
+        send_command(client, "vCont;s:1");
+        expect_stop(client);
+        EXPECT_EQ(transact(client, "vStopped"), "OK");
+        EXPECT_TRUE(t0->is_halted());
+        EXPECT_EQ(transact(client, "p20"), "04080000");
+
+        EXPECT_EQ(transact(client, "QNonStop:0"), "OK");
+        EXPECT_FALSE(t0->is_halted());
+        EXPECT_FALSE(t1->is_halted());
+
+        send_command(client, "D");
+        done = true;
+    }
+
+    virtual void run_test() override {
+        vector<debugging::target*> targets = {
+            debugging::target::find("test.cpu0"),
+            debugging::target::find("test.cpu1"),
+        };
+
+        debugging::gdbserver* gdb = new debugging::gdbserver(0, targets,
+                                                   debugging::GDB_RUNNING);
+
+        std::thread t(&gdbserver_test::run_client, this, gdb->port());
+        while (!done || !gdb->is_listening())
+            wait(1, SC_MS);
+
+        t.join();
+        delete gdb;
+        client.disconnect();
+    }
+};
+
+TEST(gdbserver, threads) {
+    tlm::tlm_global_quantum::instance().set(sc_time(1, SC_US));
+    gdbserver_test test("test");
+    sc_core::sc_start();
+}
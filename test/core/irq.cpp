@@ -32,6 +32,7 @@ class irq_test_harness : public test_base
 {
 public:
     unsigned int irq_no;
+    size_t irq_count;
     unordered_map<irq_vector, bool> irq_state;
     unordered_set<unsigned int> irq_source;
 
@@ -49,9 +50,18 @@ public:
     sc_signal<bool> signal;
     irq_initiator_adapter IA;
 
+    sc_event blocker_ev;
+
+    // holds a guard across a wait, like a transaction that syncs
+    void blocker() {
+        irq_defer_guard guard;
+        wait(blocker_ev);
+    }
+
     irq_test_harness(const sc_module_name& nm):
         test_base(nm),
         irq_no(),
+        irq_count(),
         irq_state(),
         irq_source(),
         OUT("OUT"),
@@ -62,7 +72,8 @@ public:
         A_OUT("A_OUT"),
         TA("TA"),
         signal("signal"),
-        IA("IA") {
+        IA("IA"),
+        blocker_ev("blocker_ev") {
         OUT.bind(IN[0]);
 
         // check hierarchical binding: OUT -> H_OUT -> H_IN -> IN[1]
@@ -94,6 +105,7 @@ public:
 
     virtual void irq_transport(const irq_target_socket& socket,
         irq_payload& irq) override {
+        irq_count++;
         irq_state[irq.vector] = irq.active;
         size_t source = IN.index_of(socket);
         if (irq.active)
@@ -139,6 +151,72 @@ public:
         EXPECT_FALSE(irq_source.count(0));
         EXPECT_FALSE(irq_source.count(1));
 
+        // test batched vector updates, OUT is bound to IN[0] and IN[1]
+        irq_count = 0;
+        OUT.write_vectors(0b1011, 0b0011);
+        EXPECT_EQ(irq_count, 4);
+        EXPECT_TRUE(irq_state[0]);
+        EXPECT_TRUE(irq_state[1]);
+        EXPECT_FALSE(irq_state[3]);
+        EXPECT_TRUE(OUT.read(1));
+        EXPECT_EQ(OUT.read_vectors(), 0b0011);
+        EXPECT_EQ(IN[0].read_vectors(), 0b0011);
+        EXPECT_EQ(IN[1].read_vectors(), 0b0011);
+
+        irq_count = 0;
+        OUT.write_vectors(~0ull, 0b0011);
+        OUT[1] = true;
+        EXPECT_EQ(irq_count, 0) << "redundant irq writes forwarded";
+
+        OUT.write_vectors(~0ull, 0);
+        EXPECT_EQ(irq_count, 4);
+        EXPECT_FALSE(irq_state[0]);
+        EXPECT_FALSE(irq_state[1]);
+        EXPECT_EQ(IN[0].read_vectors(), 0);
+
+        // test deferred writes, only the final state should be forwarded
+        irq_count = 0;
+        OUT.write_deferred(true);
+        OUT.write_deferred(false);
+        OUT.write_deferred(true);
+        EXPECT_TRUE(OUT.has_deferred());
+        EXPECT_EQ(irq_count, 0) << "deferred irq forwarded early";
+        EXPECT_FALSE(OUT.read());
+
+        wait(IN[0].default_event());
+        EXPECT_EQ(irq_count, 2) << "deferred transitions not suppressed";
+        EXPECT_FALSE(OUT.has_deferred());
+        EXPECT_TRUE(OUT.read());
+        EXPECT_TRUE(IN[0].read());
+        EXPECT_TRUE(IN[1].read());
+
+        irq_count = 0;
+        OUT.write_deferred(true, VECTOR);
+        OUT.write_deferred(false, VECTOR);
+        OUT.write_deferred(false);
+        irq_defer_guard::flush();
+        EXPECT_EQ(irq_count, 2) << "redundant deferred irq forwarded";
+        EXPECT_FALSE(OUT.has_deferred());
+        EXPECT_FALSE(IN[0].read());
+        EXPECT_FALSE(irq_state[VECTOR]);
+
+        // a guard blocked in another process must not delay our flush
+        sc_spawn(sc_bind(&irq_test_harness::blocker, this), "blocker");
+        wait(SC_ZERO_TIME);
+
+        irq_count = 0;
+        {
+            irq_defer_guard guard;
+            OUT.write_deferred(true);
+            EXPECT_EQ(irq_count, 0) << "deferred irq forwarded early";
+        }
+
+        EXPECT_EQ(irq_count, 2) << "deferred irq not flushed by guard";
+        EXPECT_TRUE(IN[0].read());
+        OUT = false;
+        blocker_ev.notify();
+        wait(SC_ZERO_TIME);
+
         // test hierarchy binding
         EXPECT_FALSE(signal.read());
         A_OUT = true;
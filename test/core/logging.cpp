@@ -165,3 +165,124 @@ TEST(logging, reporting) {
     EXPECT_CALL(logger, write_log(match_level(vcml::LOG_ERROR))).Times(1);
     vcml::logger::log(rep);
 }
+
+TEST(logging, async) {
+    mock_logger* logger = new mock_logger();
+    vcml::log_async async(logger);
+
+    EXPECT_CALL(*logger, write_log(match_level(vcml::LOG_INFO))).Times(2);
+    EXPECT_CALL(*logger, write_log(match_level(vcml::LOG_WARN))).Times(1);
+    EXPECT_CALL(*logger, write_log(match_level(vcml::LOG_DEBUG))).Times(0);
+    vcml::log_info("first asynchronous message");
+    vcml::log_warn("second asynchronous message");
+    vcml::log_debug("this debug message should be filtered out");
+    vcml::log_info("third asynchronous message");
+    async.flush();
+
+    EXPECT_CALL(*logger, write_log(match_level(vcml::LOG_ERROR))).Times(1);
+    vcml::log_error("errors are flushed immediately");
+    Mock::VerifyAndClearExpectations(logger);
+    EXPECT_EQ(async.dropped(), 0);
+}
+
+class gated_logger: public vcml::logger
+{
+private:
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+    bool m_open;
+    bool m_entered;
+
+public:
+    std::vector<std::string> received;
+
+    gated_logger():
+        vcml::logger(vcml::LOG_ERROR, vcml::LOG_INFO),
+        m_mtx(), m_cv(), m_open(false), m_entered(false), received() {
+    }
+
+    virtual void write_log(const vcml::logmsg& msg) override {
+        std::unique_lock<std::mutex> lock(m_mtx);
+        m_entered = true;
+        m_cv.notify_all();
+        m_cv.wait(lock, [&]() -> bool { return m_open; });
+        received.push_back(msg.lines.front());
+    }
+
+    void wait_entered() {
+        std::unique_lock<std::mutex> lock(m_mtx);
+        m_cv.wait(lock, [&]() -> bool { return m_entered; });
+    }
+
+    void open() {
+        std::lock_guard<std::mutex> guard(m_mtx);
+        m_open = true;
+        m_cv.notify_all();
+    }
+};
+
+TEST(logging, async_count_drops) {
+    gated_logger* logger = new gated_logger();
+    vcml::log_async async(logger, 4, vcml::LOG_OVERFLOW_COUNT_DROPS);
+
+    // stall the writer thread inside the first message
+    vcml::log_info("msg0");
+    logger->wait_entered();
+
+    for (int i = 1; i < 8; i++)
+        vcml::log_info("msg%d", i);
+    EXPECT_EQ(async.dropped(), 3);
+
+    logger->open();
+    async.flush();
+
+    ASSERT_EQ(logger->received.size(), 6);
+    EXPECT_EQ(logger->received[0], "msg0");
+    EXPECT_EQ(logger->received[1], "3 log messages dropped");
+    EXPECT_EQ(logger->received[2], "msg1");
+    EXPECT_EQ(logger->received[5], "msg4");
+}
+
+TEST(logging, async_drop_oldest) {
+    gated_logger* logger = new gated_logger();
+    vcml::log_async async(logger, 4, vcml::LOG_OVERFLOW_DROP_OLDEST);
+
+    vcml::log_info("msg0");
+    logger->wait_entered();
+
+    for (int i = 1; i < 8; i++)
+        vcml::log_info("msg%d", i);
+    EXPECT_EQ(async.dropped(), 3);
+
+    logger->open();
+    async.flush();
+
+    ASSERT_EQ(logger->received.size(), 6);
+    EXPECT_EQ(logger->received[0], "msg0");
+    EXPECT_EQ(logger->received[1], "3 log messages dropped");
+    EXPECT_EQ(logger->received[2], "msg4");
+    EXPECT_EQ(logger->received[5], "msg7");
+}
+
+TEST(logging, async_errors_not_dropped) {
+    gated_logger* logger = new gated_logger();
+    vcml::log_async async(logger, 4, vcml::LOG_OVERFLOW_COUNT_DROPS);
+
+    // stall the writer thread and fill up the queue
+    vcml::log_info("msg0");
+    logger->wait_entered();
+    for (int i = 1; i < 5; i++)
+        vcml::log_info("msg%d", i);
+
+    std::thread opener([logger]() -> void {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        logger->open();
+    });
+
+    vcml::log_error("fatal");
+    opener.join();
+
+    EXPECT_EQ(async.dropped(), 0);
+    ASSERT_EQ(logger->received.size(), 6);
+    EXPECT_EQ(logger->received.back(), "fatal");
+}
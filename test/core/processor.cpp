@@ -80,6 +80,10 @@ TEST(processor, processor) {
     clk.write(defclk);
     rst.write(false);
 
+    // record irq rates in one second windows
+    cpu.irq_stats_window = sc_core::sc_time(1.0, sc_core::SC_SEC);
+    cpu.irq_stats_windows = 4;
+
     // finish elaboration
     EXPECT_CALL(cpu, reset()).Times(1);
     EXPECT_CALL(cpu, handle_clock_update(0, defclk)).Times(1);
@@ -131,6 +135,47 @@ TEST(processor, processor) {
     EXPECT_FALSE(stats[0].irq_status);
     EXPECT_FALSE(stats[1].irq_status);
 
+    // one second is 2^29..2^30 nanoseconds
+    EXPECT_EQ(stats[0].irq_duration[29], 1);
+    EXPECT_EQ(stats[1].irq_duration[29], 1);
+    for (size_t i = 0; i < vcml::IRQ_STATS_BUCKETS; i++)
+        EXPECT_EQ(stats[0].irq_interval[i], 0) << "bucket " << i;
+
+    // irq0 was raised at 11s, irq1 at 13s
+    // only the last four windows are kept
+    EXPECT_EQ(stats[0].irq_rate.size(), 4);
+    EXPECT_EQ(stats[1].irq_rate.size(), 4);
+    EXPECT_EQ(stats[0].irq_rate_last, 11);
+    EXPECT_EQ(stats[1].irq_rate_last, 13);
+    EXPECT_EQ(stats[0].rate(11), 1);
+    EXPECT_EQ(stats[0].rate(10), 0);
+    EXPECT_EQ(stats[1].rate(13), 1);
+    EXPECT_EQ(stats[1].rate(9), 0);
+
+    std::stringstream ss;
+    cpu.write_irq_stats(ss);
+    std::string json = ss.str();
+    size_t irq0 = json.find("{\"irq\":0,\"count\":1");
+    size_t irq1 = json.find("{\"irq\":1,\"count\":1");
+    ASSERT_NE(irq0, std::string::npos) << json;
+    ASSERT_NE(irq1, std::string::npos) << json;
+    EXPECT_EQ(json.find("\"irqs\":[\n{\"irq\":0"), json.find("\"irqs\""))
+        << json;
+    EXPECT_EQ(json.find("},\n{"), irq1 - 3) << json;
+    EXPECT_EQ(json.find("}{"), std::string::npos) << json;
+    EXPECT_EQ(json.substr(json.size() - 4), "}]}\n") << json;
+
+    int depth = 0;
+    for (char c : json) {
+        if (c == '{' || c == '[')
+            depth++;
+        if (c == '}' || c == ']')
+            depth--;
+        EXPECT_GE(depth, 0) << json;
+    }
+
+    EXPECT_EQ(depth, 0) << json;
+
     // test processor::reset
     rst.write(true);
     EXPECT_CALL(cpu, reset()).Times(AtMost(1));
@@ -84,6 +84,37 @@ TEST(socket, send) {
     EXPECT_EQ(strcmp(str, buf), 0);
 }
 
+TEST(socket, buffered) {
+    vcml::socket server(0);
+    vcml::socket client(server.host(), server.port());
+    server.accept();
+
+    vector<u8> data(3 * vcml::socket::RXBUF_SIZE + 7);
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = (u8)(i * 7);
+
+    client.send("abc");
+    EXPECT_EQ(server.recv_char(), 'a');
+    EXPECT_EQ(server.buffered(), 2u);
+    EXPECT_EQ(server.peek(), 2u);
+    EXPECT_EQ(server.recv_char(), 'b');
+    EXPECT_EQ(server.recv_char(), 'c');
+    EXPECT_EQ(server.buffered(), 0u);
+
+    thread sender([&]() -> void { client.send(data.data(), data.size()); });
+
+    vector<u8> buffer(data.size());
+    server.recv(buffer.data(), 5);
+    server.recv(buffer.data() + 5, buffer.size() - 5);
+    EXPECT_EQ(buffer, data);
+    EXPECT_EQ(server.buffered(), 0u);
+
+    sender.join();
+    client.disconnect();
+    EXPECT_THROW(server.recv_char(), vcml::report);
+    EXPECT_FALSE(server.is_connected());
+}
+
 TEST(socket, async) {
     vcml::socket server;
     vcml::socket client;
@@ -53,25 +53,37 @@ TEST(systemc, callback) {
     on_each_delta_cycle([&delta_calls]() { delta_calls++; });
     on_each_time_step([&time_calls]() { time_calls++; });
 
+    atomic<bool> pending(false);
+    unsigned int pending_calls = 0;
+    on_each_delta_cycle([&pending_calls]() { pending_calls++; }, pending);
+
     delta_calls = time_calls = 0;
     sc_core::sc_start(SC_ZERO_TIME);
     EXPECT_EQ(delta_calls, 1);
+    EXPECT_EQ(pending_calls, 0);
+    EXPECT_EQ(sim_delta_cycles(), 1);
 #if SYSTEMC_VERSION <= SYSTEMC_VERSION_2_3_1a
     EXPECT_EQ(time_calls, 1); // SystemC <= 2.3.1a has different behavior
 #else
     EXPECT_EQ(time_calls, 0);
 #endif
 
+    pending = true;
     delta_calls = time_calls = 0;
     sc_core::sc_start(10, SC_SEC);
     EXPECT_EQ(delta_calls, 1);
     EXPECT_EQ(time_calls, 1);
+    EXPECT_EQ(pending_calls, 1);
+    EXPECT_EQ(sim_delta_cycles(), 2);
+    pending = false;
 
     delta_calls = time_calls = 0;
     sc_core::sc_start(10, SC_SEC);
     sc_core::sc_start(SC_ZERO_TIME);
     sc_core::sc_start(10, SC_SEC);
     EXPECT_EQ(delta_calls, 3);
+    EXPECT_EQ(pending_calls, 1);
+    EXPECT_EQ(sim_delta_cycles(), 5);
 #if SYSTEMC_VERSION <= SYSTEMC_VERSION_2_3_1a
     EXPECT_EQ(time_calls, 3); // SystemC <= 2.3.1a has different behavior
 #else
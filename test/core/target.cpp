@@ -0,0 +1,300 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "testing.h"
+
+class target_test: public test_base,
+                   public debugging::target,
+                   public debugging::subscriber
+{
+public:
+    vector<u64> bphits;
+    vector<range> wpreads;
+    vector<range> wpwrites;
+
+    u64 regs[2];
+    u8 mem[16];
+
+    target_test(const sc_module_name& nm = "test"):
+        test_base(nm),
+        debugging::target(),
+        debugging::subscriber(),
+        bphits(),
+        wpreads(),
+        wpwrites(),
+        regs(),
+        mem() {
+        vector<debugging::cpureg> defs;
+        defs.push_back(debugging::cpureg(0, "r0", 4, VCML_ACCESS_READ_WRITE));
+        defs.push_back(debugging::cpureg(1, "r1", 4, VCML_ACCESS_READ_WRITE));
+        define_cpuregs(defs);
+        set_little_endian();
+    }
+
+    virtual bool read_cpureg_dbg(const debugging::cpureg& reg, u64& val)
+        override {
+        if (reg.regno >= 2)
+            return false;
+        val = regs[reg.regno];
+        return true;
+    }
+
+    virtual u64 read_vmem_dbg(u64 addr, void* buffer, u64 size) override {
+        if (addr >= sizeof(mem) || size > sizeof(mem) - addr)
+            return 0;
+        memcpy(buffer, mem + addr, size);
+        return size;
+    }
+
+    virtual void notify_breakpoint_hit(const debugging::breakpoint& bp)
+        override {
+        bphits.push_back(bp.address());
+    }
+
+    virtual void notify_watchpoint_read(const debugging::watchpoint& wp,
+        const range& addr) override {
+        wpreads.push_back(wp.address());
+    }
+
+    virtual void notify_watchpoint_write(const debugging::watchpoint& wp,
+        const range& addr, u64 newval) override {
+        wpwrites.push_back(wp.address());
+    }
+
+    void test_breakpoints() {
+        EXPECT_EQ(find_breakpoint(0x0), nullptr);
+
+        for (u64 addr = 0x1000; addr < 0x5000; addr += 4)
+            ASSERT_NE(insert_breakpoint(addr, this), nullptr);
+
+        EXPECT_EQ(breakpoints().size(), 0x1000);
+        for (u64 addr = 0x1000; addr < 0x5000; addr += 4) {
+            ASSERT_TRUE(is_breakpoint(addr));
+            EXPECT_FALSE(is_breakpoint(addr + 2));
+            EXPECT_EQ(find_breakpoint(addr)->address(), addr);
+        }
+
+        EXPECT_FALSE(is_breakpoint(0xffc));
+        EXPECT_FALSE(is_breakpoint(0x5000));
+
+        for (u64 addr = 0x1000; addr < 0x5000; addr += 8)
+            EXPECT_TRUE(remove_breakpoint(lookup_breakpoint(addr), this));
+
+        EXPECT_EQ(breakpoints().size(), 0x800);
+        for (u64 addr = 0x1000; addr < 0x5000; addr += 8) {
+            EXPECT_FALSE(is_breakpoint(addr));
+            EXPECT_TRUE(is_breakpoint(addr + 4));
+        }
+
+        target::notify_breakpoint_hit(0x1000);
+        target::notify_breakpoint_hit(0x1004);
+        target::notify_breakpoint_hit(0x1006);
+        ASSERT_EQ(bphits.size(), 1);
+        EXPECT_EQ(bphits[0], 0x1004);
+        EXPECT_EQ(lookup_breakpoint(0x1004)->hit_count(), 1);
+
+        for (u64 addr = 0x1004; addr < 0x5000; addr += 8)
+            EXPECT_TRUE(remove_breakpoint(lookup_breakpoint(addr), this));
+
+        EXPECT_TRUE(breakpoints().empty());
+        EXPECT_FALSE(is_breakpoint(0x1004));
+    }
+
+    void test_watchpoints() {
+        // a large region spanning many pages overlapping smaller ones
+        const range big(0x10000, 0x8ffff);
+        const range w1(0x20000, 0x20003);
+        const range w2(0x20002, 0x20009);
+        const range w3(0x100000000, 0x100000007);
+
+        EXPECT_TRUE(insert_watchpoint(big, VCML_ACCESS_WRITE, this));
+        EXPECT_TRUE(insert_watchpoint(w1, VCML_ACCESS_READ_WRITE, this));
+        EXPECT_TRUE(insert_watchpoint(w2, VCML_ACCESS_READ, this));
+        EXPECT_TRUE(insert_watchpoint(w3, VCML_ACCESS_READ, this));
+
+        target::notify_watchpoint_read(range(0x20002, 0x20002));
+        EXPECT_EQ(wpreads.size(), 2);
+        EXPECT_TRUE(stl_contains(wpreads, w1));
+        EXPECT_TRUE(stl_contains(wpreads, w2));
+
+        target::notify_watchpoint_write(range(0x20002, 0x20002), 0);
+        EXPECT_EQ(wpwrites.size(), 2);
+        EXPECT_TRUE(stl_contains(wpwrites, w1));
+        EXPECT_TRUE(stl_contains(wpwrites, big));
+
+        wpreads.clear();
+        wpwrites.clear();
+
+        target::notify_watchpoint_read(range(0x30000, 0x30003));
+        target::notify_watchpoint_read(range(0x0, 0xfff));
+        target::notify_watchpoint_write(range(0x90000, 0x90003), 0);
+        EXPECT_TRUE(wpreads.empty());
+        EXPECT_TRUE(wpwrites.empty());
+
+        target::notify_watchpoint_read(range(0x100000004, 0x10000000b));
+        ASSERT_EQ(wpreads.size(), 1);
+        EXPECT_EQ(wpreads[0], w3);
+
+        target::notify_watchpoint_write(range(0x8fffc, 0x8ffff), 0);
+        ASSERT_EQ(wpwrites.size(), 1);
+        EXPECT_EQ(wpwrites[0], big);
+
+        wpreads.clear();
+        wpwrites.clear();
+
+        EXPECT_TRUE(remove_watchpoint(big, VCML_ACCESS_WRITE, this));
+        EXPECT_TRUE(remove_watchpoint(w1, VCML_ACCESS_READ, this));
+        target::notify_watchpoint_read(range(0x20000, 0x20003));
+        target::notify_watchpoint_write(range(0x20000, 0x20003), 0);
+        ASSERT_EQ(wpreads.size(), 1);
+        EXPECT_EQ(wpreads[0], w2);
+        ASSERT_EQ(wpwrites.size(), 1);
+        EXPECT_EQ(wpwrites[0], w1);
+
+        EXPECT_TRUE(remove_watchpoint(w1, VCML_ACCESS_WRITE, this));
+        EXPECT_TRUE(remove_watchpoint(w2, VCML_ACCESS_READ, this));
+        EXPECT_TRUE(remove_watchpoint(w3, VCML_ACCESS_READ, this));
+        EXPECT_TRUE(watchpoints().empty());
+    }
+
+    void test_conditions() {
+        debugging::condition cond;
+        EXPECT_TRUE(cond.is_empty());
+        EXPECT_TRUE(cond.evaluate(*this));
+
+        EXPECT_FALSE(cond.add_expression("r2 == 1", *this));
+        EXPECT_FALSE(cond.add_expression("r0 =! 1", *this));
+        EXPECT_FALSE(cond.add_expression("u32[r0", *this));
+        EXPECT_TRUE(cond.is_empty());
+
+        regs[0] = 4;
+        regs[1] = 7;
+        mem[4] = 0x34;
+        mem[5] = 0x12;
+
+        ASSERT_TRUE(cond.add_expression("u16[r0] == 0x1234", *this));
+        EXPECT_TRUE(cond.evaluate(*this));
+        mem[5] = 0x13;
+        EXPECT_FALSE(cond.evaluate(*this));
+        regs[0] = 0x100; // unreadable memory counts as hit
+        EXPECT_TRUE(cond.evaluate(*this));
+
+        cond.clear();
+        ASSERT_TRUE(cond.add_expression("r1 >= 8", *this));
+        EXPECT_FALSE(cond.evaluate(*this));
+        regs[1] = 8;
+        EXPECT_TRUE(cond.evaluate(*this));
+
+        // gdb agent expression for "r1 < 3 || r0 == 2", registers are
+        // looked up by their gdb number, which is regno + 10 here
+        auto lookup = [this](u64 no) -> const debugging::cpureg* {
+            return no >= 10 ? find_cpureg(no - 10) : nullptr;
+        };
+
+        const vector<u8> code = {
+            0x26, 0x00, 0x0b, // reg 11
+            0x22, 0x03,       // const8 3
+            0x15,             // less_unsigned
+            0x28,             // dup
+            0x20, 0x00, 0x11, // if_goto 17
+            0x29,             // pop
+            0x26, 0x00, 0x0a, // reg 10
+            0x22, 0x02,       // const8 2
+            0x13,             // equal
+            0x27,             // end
+        };
+
+        cond.clear();
+        EXPECT_FALSE(cond.add_agent_expr({ 0x26, 0x00, 0x01, 0x27 }, lookup));
+        EXPECT_FALSE(cond.add_agent_expr({ 0x20, 0x00, 0x10, 0x27 }, lookup));
+        EXPECT_FALSE(cond.add_agent_expr({ 0x01, 0x27 }, lookup));
+        EXPECT_FALSE(cond.add_agent_expr({ 0x22 }, lookup));
+        ASSERT_TRUE(cond.add_agent_expr(code, lookup));
+
+        regs[0] = 1;
+        regs[1] = 5;
+        EXPECT_FALSE(cond.evaluate(*this));
+        regs[0] = 2;
+        EXPECT_TRUE(cond.evaluate(*this));
+        regs[0] = 1;
+        regs[1] = 2;
+        EXPECT_TRUE(cond.evaluate(*this));
+
+        // INT64_MIN / -1 must not trap, the quotient wraps around
+        const vector<u8> sdiv = {
+            0x25, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x25, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0x05, // div_signed
+            0x25, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x13, // equal
+            0x27,
+        };
+
+        const vector<u8> srem = {
+            0x25, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x25, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0x07, // rem_signed
+            0x22, 0x00,
+            0x13, // equal
+            0x27,
+        };
+
+        cond.clear();
+        ASSERT_TRUE(cond.add_agent_expr(sdiv, lookup));
+        EXPECT_TRUE(cond.evaluate(*this));
+        cond.clear();
+        ASSERT_TRUE(cond.add_agent_expr(srem, lookup));
+        EXPECT_TRUE(cond.evaluate(*this));
+
+        // breakpoints only notify when condition holds and ignore count
+        // has been used up
+        cond.clear();
+        ASSERT_TRUE(cond.add_expression("r0 == 3", *this));
+        const debugging::breakpoint* bp;
+        bp = insert_breakpoint(0x2000, this, cond, 2);
+        ASSERT_NE(bp, nullptr);
+
+        bphits.clear();
+        for (regs[0] = 0; regs[0] < 8; regs[0]++) {
+            for (int i = 0; i < 4; i++)
+                target::notify_breakpoint_hit(0x2000);
+        }
+
+        EXPECT_EQ(bp->hit_count(), 32);
+        EXPECT_EQ(bphits.size(), 2);
+
+        // subscribing again replaces condition and ignore count
+        EXPECT_EQ(insert_breakpoint(0x2000, this), bp);
+        target::notify_breakpoint_hit(0x2000);
+        EXPECT_EQ(bphits.size(), 3);
+
+        EXPECT_TRUE(remove_breakpoint(bp, this));
+        EXPECT_TRUE(breakpoints().empty());
+    }
+
+    virtual void run_test() override {
+        test_breakpoints();
+        test_watchpoints();
+        test_conditions();
+    }
+};
+
+TEST(target, breakpoints_and_watchpoints) {
+    target_test test;
+    sc_core::sc_start();
+}
@@ -67,6 +67,49 @@ public:
 
         t1.join();
         t2.join();
+
+        // writers of resources SystemC never touches must not pause it
+        thctl_resource private_res;
+        thctl_resource sysc_res(true);
+        atomic<u64> deltas(0);
+        atomic<bool> done(false);
+        atomic<bool> advanced(false);
+        atomic<bool> paused(false);
+
+        std::thread t3([&]() -> void {
+            thctl_exclusive_guard guard(private_res);
+            u64 start = deltas;
+            for (int i = 0; i < 1000 && deltas < start + 10; i++)
+                usleep(1000);
+            advanced = deltas >= start + 10;
+            done = true;
+        });
+
+        while (!done) {
+            deltas++;
+            wait(SC_ZERO_TIME);
+        }
+
+        t3.join();
+        EXPECT_TRUE(advanced) << "SystemC paused for a private resource";
+
+        // writers of resources SystemC also modifies must pause it
+        done = false;
+        std::thread t4([&]() -> void {
+            thctl_exclusive_guard guard(sysc_res);
+            u64 start = deltas;
+            usleep(10000);
+            paused = deltas == start;
+            done = true;
+        });
+
+        while (!done) {
+            deltas++;
+            wait(SC_ZERO_TIME);
+        }
+
+        t4.join();
+        EXPECT_TRUE(paused) << "SystemC kept running during a write";
     }
 };
 
@@ -75,3 +118,34 @@ TEST(thctl, critical) {
     sc_core::sc_start();
 }
 
+
+TEST(thctl, resource) {
+    thctl_resource res;
+    atomic<int> readers(0);
+    atomic<int> writers(0);
+    atomic<bool> overlap(false);
+
+    auto reader = [&]() -> void {
+        for (int i = 0; i < 1000; i++) {
+            thctl_shared_guard guard(res);
+            readers++;
+            if (writers > 0)
+                overlap = true;
+            readers--;
+        }
+    };
+
+    auto writer = [&]() -> void {
+        for (int i = 0; i < 1000; i++) {
+            thctl_exclusive_guard guard(res);
+            if (writers++ > 0 || readers > 0)
+                overlap = true;
+            writers--;
+        }
+    };
+
+    std::thread r1(reader), r2(reader), w1(writer), w2(writer);
+    r1.join(); r2.join(); w1.join(); w2.join();
+
+    EXPECT_FALSE(overlap) << "writer did not get exclusive access";
+}
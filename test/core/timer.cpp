@@ -44,6 +44,29 @@ public:
         EXPECT_EQ(t1.count(), 1);
         EXPECT_EQ(t2.count(), 1000);
 
+        timer t4(5, SC_US, [](timer& t) -> void {
+            ADD_FAILURE() << "cancelled timer triggered";
+        });
+
+        timer t5(1, SC_SEC, [&](timer& t) -> void {
+            EXPECT_EQ(sc_time_stamp(), t.timeout());
+        });
+
+        EXPECT_TRUE(t4.is_pending());
+        t4.cancel();
+        EXPECT_FALSE(t4.is_pending());
+        t5.reset(2, SC_US);
+        t1.reset(SC_ZERO_TIME);
+
+        wait(SC_ZERO_TIME);
+        EXPECT_EQ(t1.count(), 2);
+        EXPECT_FALSE(t1.is_pending());
+
+        wait(10, SC_US);
+        EXPECT_EQ(t4.count(), 0);
+        EXPECT_EQ(t5.count(), 1);
+        EXPECT_FALSE(t5.is_pending());
+
         atomic<bool> running(true);
 
         std::promise<void> promise;
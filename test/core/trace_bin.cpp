@@ -0,0 +1,107 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+#include "testing.h"
+
+class trace_bin_test: public test_base
+{
+public:
+    tlm_initiator_socket OUT;
+    tlm_target_socket IN;
+
+    trace_bin_test(const sc_module_name& nm):
+        test_base(nm),
+        OUT("OUT"),
+        IN("IN") {
+        OUT.bind(IN);
+    }
+
+    virtual unsigned int transport(tlm_generic_payload& tx,
+        const tlm_sbi& info, address_space as) override {
+        tx.set_response_status(TLM_OK_RESPONSE);
+        return tx.get_data_length();
+    }
+
+    virtual void run_test() override {
+        string path = mkstr("/tmp/vcml_trace_bin_%d.bin", (int)getpid());
+
+        loglvl = LOG_TRACE;
+        trace_bin* bin = new trace_bin(path);
+        EXPECT_EQ(trace_bin::active(), bin);
+
+        EXPECT_OK(OUT.writew(0x420, 0x1234u, SBI_INSN));
+        bin->flush();
+        EXPECT_EQ(bin->records(), 6);
+
+        delete bin;
+        EXPECT_EQ(trace_bin::active(), nullptr);
+
+        FILE* f = fopen(path.c_str(), "rb");
+        ASSERT_NE(f, nullptr);
+
+        trace_file_header header;
+        ASSERT_EQ(fread(&header, sizeof(header), 1, f), 1);
+        EXPECT_STREQ(header.magic, TRACE_FORMAT_MAGIC);
+        EXPECT_EQ(header.version, TRACE_FORMAT_VERSION);
+        EXPECT_EQ(header.record_size, sizeof(trace_record));
+        EXPECT_GT(header.resolution, 0);
+
+        trace_record recs[6];
+        ASSERT_EQ(fread(recs, sizeof(trace_record), 6, f), 6);
+        EXPECT_EQ(fread(recs, sizeof(trace_record), 1, f), 0);
+        fclose(f);
+        remove(path.c_str());
+
+        EXPECT_EQ(recs[0].kind, TRACE_RECORD_NAME);
+        EXPECT_STREQ(recs[0].name, OUT.name());
+        EXPECT_EQ(recs[2].kind, TRACE_RECORD_NAME);
+        EXPECT_STREQ(recs[2].name, IN.name());
+
+        const u8 expected_kinds[] = {
+            TRACE_RECORD_NAME, TRACE_RECORD_FW,
+            TRACE_RECORD_NAME, TRACE_RECORD_FW,
+            TRACE_RECORD_BW, TRACE_RECORD_BW,
+        };
+
+        const u32 expected_ids[] = { 0, 0, 1, 1, 1, 0 };
+
+        for (size_t i = 0; i < 6; i++) {
+            EXPECT_EQ(recs[i].kind, expected_kinds[i]) << "record " << i;
+            EXPECT_EQ(recs[i].socket, expected_ids[i]) << "record " << i;
+            if (recs[i].kind == TRACE_RECORD_NAME)
+                continue;
+
+            EXPECT_EQ(recs[i].command, TLM_WRITE_COMMAND);
+            EXPECT_EQ(recs[i].addr, 0x420);
+            EXPECT_EQ(recs[i].size, 4);
+            EXPECT_EQ(recs[i].data[0], 0x34);
+            EXPECT_EQ(recs[i].data[1], 0x12);
+            EXPECT_TRUE(recs[i].flags & TRACE_FLAG_INSN);
+        }
+
+        EXPECT_EQ(recs[1].response, TLM_INCOMPLETE_RESPONSE);
+        EXPECT_EQ(recs[5].response, TLM_OK_RESPONSE);
+        EXPECT_EQ(recs[1].latency, 0);
+        EXPECT_GE(recs[5].time, recs[1].time);
+        EXPECT_EQ(recs[5].latency, recs[5].time - recs[1].time);
+    }
+};
+
+TEST(trace_bin, transactions) {
+    trace_bin_test test("harness");
+    sc_core::sc_start();
+}
@@ -0,0 +1,117 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "testing.h"
+
+MATCHER_P(match_trace, msg, "matches if trace message contains string") {
+    if (arg.level != LOG_TRACE)
+        return false;
+    if (arg.lines.size() != 1)
+        return false;
+    return arg.lines[0].find(msg) != std::string::npos;
+}
+
+class mock_logger: public vcml::logger
+{
+public:
+    mock_logger(): vcml::logger(vcml::LOG_TRACE, vcml::LOG_TRACE) {}
+    MOCK_METHOD(void, write_log, (const vcml::logmsg&), (override));
+};
+
+class test_harness: public test_base
+{
+public:
+    mock_logger mock;
+
+    vcml::module sub;
+
+    tlm_initiator_socket OUT;
+    tlm_target_socket IN;
+
+    test_harness(const sc_module_name& nm):
+        test_base(nm),
+        mock(),
+        sub("sub"),
+        OUT("OUT"),
+        IN("IN") {
+        OUT.bind(IN);
+    }
+
+    virtual unsigned int transport(tlm_generic_payload& tx,
+        const tlm_sbi& info, address_space as) override {
+        tx.set_response_status(TLM_OK_RESPONSE);
+        return tx.get_data_length();
+    }
+
+    virtual void run_test() override {
+        loglvl = LOG_TRACE;
+        u32 data = 0x1234;
+
+        EXPECT_FALSE(is_traced(OUT));
+        EXPECT_TRUE(is_traced(IN));
+
+        EXPECT_EQ(sub.trace_sockets.get(), "IN");
+        EXPECT_EQ(sub.trace_start.get(), 0x400);
+        EXPECT_EQ(sub.trace_end.get(), 0x4ff);
+        EXPECT_FALSE(sub.trace_insn);
+        EXPECT_TRUE(sub.trace_writes);
+
+        // only the target socket is traced, and only inside the range
+        EXPECT_CALL(mock, write_log(match_trace(">> WR 0x00000420"))).Times(1);
+        EXPECT_CALL(mock, write_log(match_trace("<< WR 0x00000420"))).Times(1);
+        EXPECT_OK(OUT.writew(0x420, data));
+        Mock::VerifyAndClearExpectations(&mock);
+
+        EXPECT_CALL(mock, write_log(_)).Times(0);
+        EXPECT_OK(OUT.writew(0x3fc, data));
+        EXPECT_OK(OUT.writew(0x500, data));
+        EXPECT_OK(OUT.readw(0x420, data, SBI_INSN));
+        Mock::VerifyAndClearExpectations(&mock);
+
+        // accesses overlapping the range boundaries are still traced
+        EXPECT_CALL(mock, write_log(match_trace(">> RD 0x000004fe"))).Times(1);
+        EXPECT_CALL(mock, write_log(match_trace("<< RD 0x000004fe"))).Times(1);
+        EXPECT_OK(OUT.readw(0x4fe, data));
+        Mock::VerifyAndClearExpectations(&mock);
+
+        // filters can be changed at runtime, accesses at the very top of
+        // the address space must not wrap around
+        trace_start = ~0ull - 0xff;
+        trace_end = ~0ull;
+
+        EXPECT_CALL(mock, write_log(_)).Times(0);
+        EXPECT_OK(OUT.writew(0x420, data));
+        Mock::VerifyAndClearExpectations(&mock);
+
+        u64 data64 = 0;
+        EXPECT_CALL(mock, write_log(_)).Times(2);
+        EXPECT_OK(OUT.writew(~0ull - 3, data64));
+        Mock::VerifyAndClearExpectations(&mock);
+    }
+};
+
+TEST(tracing, filter) {
+    vcml::broker broker("test");
+    broker.define("harness.trace_sockets", "IN");
+    broker.define("harness.trace_start", "0x400");
+    broker.define("harness.trace_end", "0x4ff");
+    broker.define("harness.trace_insn", "false");
+
+    test_harness test("harness");
+    sc_core::sc_start();
+}
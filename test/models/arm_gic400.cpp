@@ -35,6 +35,8 @@ public:
     sc_vector<irq_target_socket> VFIRQ_IN;
     sc_vector<irq_target_socket> VNIRQ_IN;
 
+    arm::gic400* gic;
+
     gic400_stim(const sc_module_name& nm):
         test_base(nm),
         DISTIF_OUT("DISTIF_OUT"),
@@ -46,7 +48,24 @@ public:
         FIRQ_IN("FIRQ_IN", 2),
         NIRQ_IN("NIRQ_IN", 2),
         VFIRQ_IN("VFIRQ_IN", 2),
-        VNIRQ_IN("VNIRQ_IN", 2) {
+        VNIRQ_IN("VNIRQ_IN", 2),
+        gic(nullptr) {
+    }
+
+    u32 hppir(int cpu) {
+        const u64 GICC_HPPIR = 0x18;
+        u32 val = 0;
+        EXPECT_OK(CPUIF_OUT.readw(GICC_HPPIR, val, SBI_CPUID(cpu)))
+            << "failed to read GICC_HPPIR of cpu" << cpu;
+        return val;
+    }
+
+    // priorities and targets only take effect with the next update
+    void reevaluate() {
+        const u64 GICD_CTLR = 0x000;
+        EXPECT_OK(DISTIF_OUT.writew(GICD_CTLR, 1u))
+            << "failed to write GICD_CTLR";
+        wait(SC_ZERO_TIME);
     }
 
     virtual void run_test() override {
@@ -462,6 +481,92 @@ public:
         EXPECT_OK(DISTIF_OUT.writew(GICD_IPRIORITY_SPI,val))
             << "failed to write GICD_IPRIORITY_SPI register";
 
+        /**********************************************************************
+         *                                                                    *
+         * SPI Test - change priority and target of pending SPIs              *
+         *                                                                    *
+         **********************************************************************/
+
+        const u64 GICD_ICENABLER_SPI = 0x184; // Interrupt Clear-Enable
+        const u64 GICD_ICPENDR_SPI = 0x284;   // Interrupt Clear-Pending
+
+        for (int cpu = 0; cpu < 2; cpu++) {
+            EXPECT_OK(CPUIF_OUT.writew(GICC_CTLR, 1u, SBI_CPUID(cpu)))
+                << "failed to set GICC_CTLR for cpu" << cpu;
+            EXPECT_OK(CPUIF_OUT.writew(GICC_PMR, 0xf0u, SBI_CPUID(cpu)))
+                << "failed to set GICC_PMR for cpu" << cpu;
+        }
+
+        // irq 32 at priority 0x80 and irq 33 at 0x40, both for cpu0
+        EXPECT_OK(DISTIF_OUT.writew<u8>(GICD_ITARGETS_SPI + 0, 1));
+        EXPECT_OK(DISTIF_OUT.writew<u8>(GICD_ITARGETS_SPI + 1, 1));
+        EXPECT_OK(DISTIF_OUT.writew<u8>(GICD_IPRIORITY_SPI + 0, 0x80));
+        EXPECT_OK(DISTIF_OUT.writew<u8>(GICD_IPRIORITY_SPI + 1, 0x40));
+        EXPECT_OK(DISTIF_OUT.writew(GICD_ISENABLER_SPI, 0b11u));
+        EXPECT_OK(DISTIF_OUT.writew(GICD_CTLR, 1u));
+
+        SPI_OUT[0].write(true);
+        SPI_OUT[1].write(true);
+        wait(SC_ZERO_TIME);
+        wait(SC_ZERO_TIME);
+
+        EXPECT_EQ(NIRQ_IN[0], 1) << "IRQ should have been signaled to cpu0";
+        EXPECT_EQ(NIRQ_IN[1], 0) << "IRQ should not have been signaled to cpu1";
+        EXPECT_EQ(hppir(0), 33) << "irq 33 has the higher priority";
+        EXPECT_EQ(hppir(1), 1023) << "no irq targets cpu1";
+
+        // lowering the priority of irq 33 makes irq 32 the best one
+        EXPECT_OK(DISTIF_OUT.writew<u8>(GICD_IPRIORITY_SPI + 1, 0xa0));
+        reevaluate();
+        EXPECT_EQ(hppir(0), 32) << "priority change of irq 33 ignored";
+
+        // moving irq 32 over to cpu1 leaves irq 33 for cpu0
+        EXPECT_OK(DISTIF_OUT.writew<u8>(GICD_ITARGETS_SPI + 0, 2));
+        reevaluate();
+        EXPECT_EQ(hppir(0), 33) << "irq 32 still targets cpu0";
+        EXPECT_EQ(hppir(1), 32) << "irq 32 does not target cpu1";
+        EXPECT_EQ(NIRQ_IN[1], 1) << "IRQ should have been signaled to cpu1";
+
+        // a distributor reset clears all targets of the pending irqs
+        gic->DISTIF.reset();
+        reevaluate();
+        EXPECT_EQ(hppir(0), 1023) << "irq pending after distributor reset";
+        EXPECT_EQ(hppir(1), 1023) << "irq pending after distributor reset";
+        EXPECT_EQ(NIRQ_IN[0], 0) << "IRQ still signaled after reset";
+        EXPECT_EQ(NIRQ_IN[1], 0) << "IRQ still signaled after reset";
+
+        // irq 33 is still pending and now has the reset priority
+        EXPECT_OK(DISTIF_OUT.writew<u8>(GICD_ITARGETS_SPI + 1, 2));
+        reevaluate();
+        EXPECT_EQ(hppir(0), 1023) << "irq 33 should only target cpu1";
+        EXPECT_EQ(hppir(1), 33) << "irq 33 does not target cpu1";
+
+        val = 0;
+        EXPECT_OK(CPUIF_OUT.readw(GICC_IAR, val, SBI_CPUID(1)))
+            << "failed to read GICC_IAR of cpu1";
+        EXPECT_EQ(val, 33) << "read wrong interrupt value from GICC_IAR";
+        EXPECT_OK(CPUIF_OUT.readw(GICC_RPR, val, SBI_CPUID(1)))
+            << "failed to read GICC_RPR of cpu1";
+        EXPECT_EQ(val, 0) << "reset priority of irq 33 not used";
+        EXPECT_OK(CPUIF_OUT.writew(GICC_EOIR, 33u, SBI_CPUID(1)))
+            << "cpu1 failed to write in GICC_EOIR";
+
+        SPI_OUT[0].write(false);
+        SPI_OUT[1].write(false);
+        wait(SC_ZERO_TIME);
+
+        // reset registers
+        val = 0x0;
+        EXPECT_OK(DISTIF_OUT.writew(GICD_ICPENDR_SPI, 0b11u));
+        EXPECT_OK(DISTIF_OUT.writew(GICD_ICENABLER_SPI, 0b11u));
+        EXPECT_OK(DISTIF_OUT.writew(GICD_ITARGETS_SPI, val));
+        EXPECT_OK(DISTIF_OUT.writew(GICD_IPRIORITY_SPI, val));
+        EXPECT_OK(DISTIF_OUT.writew(GICD_CTLR, val));
+        for (int cpu = 0; cpu < 2; cpu++) {
+            EXPECT_OK(CPUIF_OUT.writew(GICC_PMR, val, SBI_CPUID(cpu)));
+            EXPECT_OK(CPUIF_OUT.writew(GICC_CTLR, val, SBI_CPUID(cpu)));
+        }
+
         /**********************************************************************
          *                                                                    *
          *              Virtual Interrupt Test                                *
@@ -662,6 +767,7 @@ TEST(gic400, gic400) {
 
     gic400_stim stim("STIM");
     arm::gic400 gic400("GIC400");
+    stim.gic = &gic400;
 
     stim.CLOCK.stub(100 * MHz);
     stim.RESET.stub();
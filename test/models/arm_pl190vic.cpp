@@ -0,0 +1,126 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+#include "testing.h"
+
+class pl190vic_stim: public test_base
+{
+public:
+    tlm_initiator_socket OUT;
+
+    sc_vector<irq_initiator_socket> IRQ_OUT;
+    irq_target_socket IRQ_IN;
+    irq_target_socket FIQ_IN;
+
+    size_t irq_edges;
+
+    pl190vic_stim(const sc_module_name& nm):
+        test_base(nm),
+        OUT("OUT"),
+        IRQ_OUT("IRQ_OUT", VCML_ARM_PL190VIC_NIRQ),
+        IRQ_IN("IRQ_IN"),
+        FIQ_IN("FIQ_IN"),
+        irq_edges(0) {
+    }
+
+    virtual void irq_transport(const irq_target_socket& socket,
+        irq_payload& irq) override {
+        if (&socket == &IRQ_IN)
+            irq_edges++;
+    }
+
+    u32 vect_addr() {
+        u32 addr = 0;
+        EXPECT_OK(OUT.readw(0x030, addr)) << "cannot read ADDR";
+        return addr;
+    }
+
+    virtual void run_test() override {
+        const u32 enabled = arm::pl190vic::VCTRL_ENABLED;
+
+        // slot 0 has highest priority, source 9 appears twice
+        const u32 sources[] = { 5, 3, 9, 7, 9 };
+        for (u32 slot = 0; slot < 5; slot++) {
+            u32 vaddr = 0x1000 + slot * 0x100;
+            EXPECT_OK(OUT.writew(0x100 + slot * 4, vaddr));
+            EXPECT_OK(OUT.writew(0x200 + slot * 4, enabled | sources[slot]));
+        }
+
+        EXPECT_OK(OUT.writew(0x010, ~0u)) << "cannot write INTE";
+        EXPECT_FALSE(IRQ_IN.read()) << "irq raised without source";
+
+        IRQ_OUT[7] = true;
+        EXPECT_TRUE(IRQ_IN.read()) << "irq not raised";
+        EXPECT_FALSE(FIQ_IN.read()) << "fiq raised for irq";
+        EXPECT_EQ(vect_addr(), 0x1300) << "wrong vector for source 7";
+
+        IRQ_OUT[9] = true;
+        EXPECT_EQ(vect_addr(), 0x1200) << "lowest slot of source 9 ignored";
+
+        IRQ_OUT[3] = true;
+        EXPECT_EQ(vect_addr(), 0x1100) << "slot 1 did not preempt slot 2";
+
+        IRQ_OUT[5] = true;
+        EXPECT_EQ(vect_addr(), 0x1000) << "slot 0 did not preempt slot 1";
+
+        // end of interrupt for source 5, source 3 is next in line
+        EXPECT_OK(OUT.writew(0x030, 0u)) << "cannot write ADDR";
+        EXPECT_EQ(vect_addr(), 0x1100) << "wrong vector after eoi";
+
+        // disabling slot 1 leaves source 3 without vector
+        EXPECT_OK(OUT.writew(0x204, 3u)) << "cannot write VCTRL1";
+        IRQ_OUT[9] = false;
+        IRQ_OUT[9] = true;
+        EXPECT_EQ(vect_addr(), 0x1200) << "disabled slot still used";
+
+        // unassigned sources still raise the non-vectored irq
+        for (unsigned int irq : { 3, 7, 9 })
+            IRQ_OUT[irq] = false;
+        EXPECT_OK(OUT.writew(0x014, ~0u)) << "cannot write IECR";
+        EXPECT_FALSE(IRQ_IN.read()) << "irq not cleared";
+        EXPECT_OK(OUT.writew(0x010, 1u << 12)) << "cannot write INTE";
+        IRQ_OUT[12] = true;
+        EXPECT_TRUE(IRQ_IN.read()) << "non-vectored irq not raised";
+        IRQ_OUT[12] = false;
+        EXPECT_FALSE(IRQ_IN.read()) << "non-vectored irq not cleared";
+
+        // source 5 is still active: the INTE, IECR and SINT writes of this
+        // burst would raise, lower and raise the irq again one by one
+        const u32 burst[4] = { 1u << 5 | 1u << 1, 1u << 5, 1u << 1, 0u };
+        irq_edges = 0;
+        EXPECT_OK(OUT.write(0x010, burst, sizeof(burst)));
+        EXPECT_TRUE(IRQ_IN.read()) << "irq not raised after burst";
+        EXPECT_EQ(irq_edges, 1) << "burst not coalesced into one edge";
+    }
+};
+
+TEST(pl190vic, priority) {
+    pl190vic_stim stim("STIM");
+    arm::pl190vic vic("VIC");
+
+    vic.CLOCK.stub(100 * MHz);
+    vic.RESET.stub();
+
+    stim.OUT.bind(vic.IN);
+    vic.IRQ_OUT[0].bind(stim.IRQ_IN);
+    vic.FIQ_OUT[0].bind(stim.FIQ_IN);
+
+    for (size_t irq = 0; irq < VCML_ARM_PL190VIC_NIRQ; irq++)
+        stim.IRQ_OUT[irq].bind(vic.IRQ_IN[irq]);
+
+    sc_core::sc_start();
+}
@@ -41,6 +41,10 @@ public:
         const u64 TIMER1_LOAD    = 0x00;
         const u64 TIMER1_VALUE   = 0x04;
         const u64 TIMER1_CONTROL = 0x08;
+        const u64 TIMER1_INTCLR  = 0x0c;
+        const u64 TIMER2_LOAD    = 0x20;
+        const u64 TIMER2_VALUE   = 0x24;
+        const u64 TIMER2_CONTROL = 0x28;
         u32 val;
 
         val = 0x100;
@@ -86,6 +90,51 @@ public:
         val = 0;
         EXPECT_OK(OUT.readw(TIMER1_CONTROL, val)) << "cannot read CONTROL";
         EXPECT_EQ(val, 0x20) << "TIMER1_CONTROL did not reset";
+
+        // periodic counter keeps running while its interrupt is masked
+        const u32 periodic = arm::sp804timer::timer::CONTROL_ENABLED |
+                             arm::sp804timer::timer::CONTROL_PERIOD  |
+                             arm::sp804timer::timer::CONTROL_32BIT;
+
+        EXPECT_OK(OUT.writew(TIMER1_LOAD, 1000u));
+        EXPECT_OK(OUT.writew(TIMER1_CONTROL, periodic));
+        wait(clock_cycles(2500));
+        EXPECT_FALSE(IRQ1) << "masked interrupt fired";
+        EXPECT_OK(OUT.readw(TIMER1_VALUE, val));
+        EXPECT_EQ(val, 500) << "periodic counter did not reload";
+
+        // unmasking continues counting down from the current value
+        start = sc_time_stamp();
+        val = periodic | arm::sp804timer::timer::CONTROL_IRQEN;
+        EXPECT_OK(OUT.writew(TIMER1_CONTROL, val));
+        wait(IRQ1.default_event());
+        EXPECT_TRUE(IRQ1) << "unmasked interrupt did not fire";
+        EXPECT_EQ(sc_time_stamp(), start + clock_cycles(500));
+
+        // counter keeps running while the interrupt is pending
+        wait(clock_cycles(3250));
+        EXPECT_TRUE(IRQ1) << "pending interrupt got lost";
+        EXPECT_OK(OUT.readw(TIMER1_VALUE, val));
+        EXPECT_EQ(val, 750) << "counter stopped while interrupt pending";
+
+        // clearing the interrupt rearms for the next period
+        start = sc_time_stamp();
+        EXPECT_OK(OUT.writew(TIMER1_INTCLR, 1u));
+        EXPECT_FALSE(IRQ1) << "interrupt not cleared";
+        wait(IRQ1.default_event());
+        EXPECT_TRUE(IRQ1) << "periodic interrupt did not fire";
+        EXPECT_EQ(sc_time_stamp(), start + clock_cycles(750));
+        EXPECT_OK(OUT.writew(TIMER1_CONTROL, 0u));
+
+        // free running 16bit counter with prescaler 16 wraps to 0xffff
+        EXPECT_OK(OUT.writew(TIMER2_LOAD, 0x10u));
+        val = arm::sp804timer::timer::CONTROL_ENABLED |
+              1u << arm::sp804timer::timer::CTLR_PRESCALE_O;
+        EXPECT_OK(OUT.writew(TIMER2_CONTROL, val));
+        wait(clock_cycles(16 * 0x14));
+        EXPECT_OK(OUT.readw(TIMER2_VALUE, val));
+        EXPECT_EQ(val, 0xfffb) << "free running counter did not wrap";
+        EXPECT_FALSE(IRQ2) << "masked interrupt fired";
     }
 };
 
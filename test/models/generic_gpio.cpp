@@ -0,0 +1,122 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+#include "testing.h"
+
+class gpio_stim: public test_base
+{
+public:
+    size_t changes;
+
+    tlm_initiator_socket OUT;
+    sc_vector<sc_signal<bool>> LINES;
+
+    gpio_stim(const sc_module_name& nm):
+        test_base(nm),
+        changes(0),
+        OUT("OUT"),
+        LINES("LINES", generic::gpio::NLINES) {
+        for (size_t line = 0; line < LINES.size(); line++) {
+            sc_spawn_options opts;
+            opts.spawn_method();
+            opts.set_sensitivity(&LINES[line].value_changed_event());
+            opts.dont_initialize();
+
+            sc_spawn(sc_bind(&gpio_stim::line_changed, this),
+                     mkstr("line%zu", line).c_str(), &opts);
+        }
+    }
+
+    void line_changed() {
+        changes++;
+    }
+
+    // wait for the ports to update their signals and count the changes
+    size_t settle() {
+        wait(SC_ZERO_TIME);
+        wait(SC_ZERO_TIME);
+        size_t result = changes;
+        changes = 0;
+        return result;
+    }
+
+    bool line(size_t idx) {
+        return LINES[idx].read();
+    }
+
+    virtual void run_test() override {
+        // 64bit access covers DATA0 and DATA1
+        EXPECT_OK(OUT.writew<u64>(0x00, 0x0000000180000000ull));
+        EXPECT_EQ(settle(), 2);
+        EXPECT_TRUE(line(31));
+        EXPECT_TRUE(line(32));
+        EXPECT_FALSE(line(30));
+        EXPECT_FALSE(line(33));
+
+        // setting all lines only forwards those that were still cleared
+        for (u64 addr = 0x20; addr < 0x40; addr += 8)
+            EXPECT_OK(OUT.writew<u64>(addr, ~0ull));
+        EXPECT_EQ(settle(), generic::gpio::NLINES - 2);
+        for (size_t idx = 0; idx < generic::gpio::NLINES; idx++)
+            EXPECT_TRUE(line(idx)) << "GPIO" << idx << " not set";
+
+        u32 data = 0;
+        EXPECT_OK(OUT.readw<u32>(0x1c, data));
+        EXPECT_EQ(data, ~0u);
+        EXPECT_CE(OUT.readw<u32>(0x20, data)) << "SET is readable";
+
+        // toggle lines 96..111
+        EXPECT_OK(OUT.writew<u32>(0x6c, 0x0000ffffu));
+        EXPECT_EQ(settle(), 16);
+        EXPECT_FALSE(line(96));
+        EXPECT_FALSE(line(111));
+        EXPECT_TRUE(line(112));
+        EXPECT_OK(OUT.readw<u32>(0x0c, data));
+        EXPECT_EQ(data, 0xffff0000u);
+
+        // redundant writes must not change any lines
+        EXPECT_OK(OUT.writew<u32>(0x2c, 0xffff0000u));
+        EXPECT_OK(OUT.writew<u32>(0x4c, 0x0000ffffu));
+        EXPECT_EQ(settle(), 0);
+
+        // clearing everything only forwards the lines still set
+        for (u64 addr = 0x40; addr < 0x60; addr += 8)
+            EXPECT_OK(OUT.writew<u64>(addr, ~0ull));
+        EXPECT_EQ(settle(), generic::gpio::NLINES - 16);
+        for (size_t idx = 0; idx < generic::gpio::NLINES; idx++)
+            EXPECT_FALSE(line(idx)) << "GPIO" << idx << " not cleared";
+
+        for (u64 addr = 0x00; addr < 0x20; addr += 4) {
+            EXPECT_OK(OUT.readw<u32>(addr, data));
+            EXPECT_EQ(data, 0) << "DATA not cleared at " << addr;
+        }
+    }
+};
+
+TEST(gpio, lines) {
+    gpio_stim stim("STIM");
+    generic::gpio gpio("GPIO");
+
+    gpio.CLOCK.stub(100 * MHz);
+    gpio.RESET.stub();
+
+    stim.OUT.bind(gpio.IN);
+    for (size_t idx = 0; idx < generic::gpio::NLINES; idx++)
+        gpio.GPIO[idx].bind(stim.LINES[idx]);
+
+    sc_core::sc_start();
+}
@@ -0,0 +1,62 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+#include "testing.h"
+
+class throttle_test: public test_base
+{
+public:
+    meta::throttle throttle;
+
+    throttle_test(const sc_module_name& nm = sc_gen_unique_name("test")):
+        test_base(nm),
+        throttle("throttle") {
+        throttle.update_interval = sc_time(1.0, SC_MS);
+        throttle.rtf = 1.0;
+    }
+
+    virtual void run_test() override {
+        wait(10, SC_MS);
+        throttle.reset_stats();
+
+        u64 start = timestamp_ns();
+        wait(50, SC_MS);
+        u64 elapsed = timestamp_ns() - start;
+
+        EXPECT_TRUE(throttle.is_throttling());
+        EXPECT_GE(elapsed, 49000000ull);
+        EXPECT_LT(throttle.avg_lag_ns(), 1000000ull);
+        EXPECT_GT(throttle.sleep_ratio(), 0.0);
+
+        std::stringstream ss;
+        EXPECT_TRUE(throttle.execute("stats", {}, ss));
+        EXPECT_NE(ss.str().find("max lag"), string::npos);
+
+        throttle.rtf = 0.0;
+        wait(1, SC_MS);
+        EXPECT_FALSE(throttle.is_throttling());
+
+        start = timestamp_ns();
+        wait(1, SC_SEC);
+        EXPECT_LT(timestamp_ns() - start, 500000000ull);
+    }
+};
+
+TEST(throttle, pacing) {
+    throttle_test test;
+    sc_core::sc_start();
+}
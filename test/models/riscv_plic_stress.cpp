@@ -0,0 +1,163 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+#include "testing.h"
+
+class plic_stress: public test_base
+{
+public:
+    enum : size_t {
+        NUM_SOURCES = 1023,
+        NUM_CONTEXTS = 4,
+        NUM_STEPS = 20000,
+        MAX_PRIO = 8,
+    };
+
+    tlm_initiator_socket OUT;
+
+    sc_vector<irq_initiator_socket> IRQS;
+    sc_vector<irq_target_socket> IRQT;
+
+    // reference model
+    bool level[NUM_SOURCES + 1];
+    bool enabled[NUM_CONTEXTS][NUM_SOURCES + 1];
+    u32 claims[NUM_SOURCES + 1];
+    u32 priority[NUM_SOURCES + 1];
+    u32 threshold[NUM_CONTEXTS];
+
+    plic_stress(const sc_module_name& nm):
+        test_base(nm),
+        OUT("OUT"),
+        IRQS("IRQS", NUM_SOURCES),
+        IRQT("IRQT", NUM_CONTEXTS),
+        level(),
+        enabled(),
+        claims(),
+        priority(),
+        threshold() {
+        for (u32& claim : claims)
+            claim = ~0u;
+    }
+
+    u32 expected_claim(size_t ctx) const {
+        u32 irq = 0, best = threshold[ctx];
+        for (u32 i = 1; i <= NUM_SOURCES; i++) {
+            if (level[i] && enabled[ctx][i] && claims[i] == ~0u &&
+                priority[i] > best) {
+                irq = i;
+                best = priority[i];
+            }
+        }
+
+        return irq;
+    }
+
+    void check_outputs(size_t step) {
+        for (size_t ctx = 0; ctx < NUM_CONTEXTS; ctx++) {
+            bool expect = expected_claim(ctx) > 0;
+            ASSERT_EQ(IRQT[ctx].read(), expect)
+                << "context " << ctx << " mismatch at step " << step;
+        }
+    }
+
+    void write_enabled(size_t ctx, size_t word, u32 val) {
+        ASSERT_OK(OUT.writew(0x2000 + (ctx * 32 + word) * 4, val));
+        for (size_t bit = 0; bit < 32; bit++) {
+            size_t irq = word * 32 + bit;
+            if (irq > 0 && irq <= NUM_SOURCES)
+                enabled[ctx][irq] = (val >> bit) & 1;
+        }
+    }
+
+    void step(size_t n) {
+        size_t op = rand() % 100;
+        size_t irq = 1 + rand() % NUM_SOURCES;
+        size_t ctx = rand() % NUM_CONTEXTS;
+
+        if (op < 60) {
+            level[irq] = !level[irq];
+            IRQS[irq - 1] = level[irq];
+        } else if (op < 70) {
+            u32 prio = rand() % MAX_PRIO;
+            ASSERT_OK(OUT.writew(irq * 4, prio));
+            priority[irq] = prio;
+        } else if (op < 78) {
+            write_enabled(ctx, rand() % 32, rand() & rand());
+        } else if (op < 82) {
+            u32 th = rand() % MAX_PRIO;
+            ASSERT_OK(OUT.writew(0x200000 + ctx * 0x1000, th));
+            threshold[ctx] = th;
+        } else if (op < 92) {
+            u32 claim = ~0u, expect = expected_claim(ctx);
+            ASSERT_OK(OUT.readw(0x200004 + ctx * 0x1000, claim));
+            ASSERT_EQ(claim, expect) << "wrong claim at step " << n;
+            if (claim > 0)
+                claims[claim] = ctx;
+        } else {
+            for (u32 i = 1; i <= NUM_SOURCES; i++) {
+                u32 j = 1 + (irq + i) % NUM_SOURCES;
+                if (claims[j] != ~0u) {
+                    ASSERT_OK(OUT.writew(0x200004 + claims[j] * 0x1000, j));
+                    claims[j] = ~0u;
+                    break;
+                }
+            }
+        }
+
+        check_outputs(n);
+    }
+
+    virtual void run_test() override {
+        srand(42);
+
+        wait(SC_ZERO_TIME);
+        for (size_t ctx = 0; ctx < NUM_CONTEXTS; ctx++)
+            EXPECT_FALSE(IRQT[ctx].read()) << "context " << ctx;
+
+        // start with everything enabled to get plenty of contention
+        for (size_t ctx = 0; ctx < NUM_CONTEXTS; ctx++)
+            for (size_t word = 0; word < 32; word++)
+                write_enabled(ctx, word, ~0u);
+
+        for (size_t n = 0; n < NUM_STEPS; n++) {
+            step(n);
+            if (::testing::Test::HasFatalFailure())
+                break;
+        }
+
+        wait(SC_ZERO_TIME);
+        check_outputs(NUM_STEPS);
+    }
+};
+
+TEST(plic, stress) {
+    plic_stress stim("STIM");
+    riscv::plic plic("PLIC");
+
+    plic.CLOCK.stub(100 * MHz);
+    plic.RESET.stub();
+
+    stim.OUT.bind(plic.IN);
+
+    for (size_t i = 0; i < plic_stress::NUM_SOURCES; i++)
+        stim.IRQS[i].bind(plic.IRQS[i + 1]);
+
+    for (size_t ctx = 0; ctx < plic_stress::NUM_CONTEXTS; ctx++)
+        plic.IRQT[ctx].bind(stim.IRQT[ctx]);
+
+    sc_core::sc_start();
+}
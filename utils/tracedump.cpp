@@ -0,0 +1,220 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2021 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include <string>
+#include <unordered_map>
+#include <algorithm>
+
+#include "vcml/common/systemc.h"
+#include "vcml/logging/logger.h"
+#include "vcml/logging/trace_format.h"
+
+using namespace vcml;
+
+using std::string;
+using std::unordered_map;
+using std::min;
+using std::max;
+
+static void print_usage(const char* name) {
+    fprintf(stderr, "Usage: %s [--csv] [-o <output>] <trace>\n", name);
+}
+
+static const char* response_str(i8 resp) {
+    switch (resp) {
+    case  1: return "TLM_OK_RESPONSE";
+    case  0: return "TLM_INCOMPLETE_RESPONSE";
+    case -1: return "TLM_GENERIC_ERROR_RESPONSE";
+    case -2: return "TLM_ADDRESS_ERROR_RESPONSE";
+    case -3: return "TLM_COMMAND_ERROR_RESPONSE";
+    case -4: return "TLM_BURST_ERROR_RESPONSE";
+    case -5: return "TLM_BYTE_ENABLE_ERROR_RESPONSE";
+    default: return "TLM_UNKNOWN_RESPONSE";
+    }
+}
+
+static const char* command_str(u8 cmd) {
+    switch (cmd) {
+    case 0:  return "RD";
+    case 1:  return "WR";
+    default: return "IG";
+    }
+}
+
+static u64 to_ps(u64 value, u64 resolution) {
+    return (u64)((unsigned __int128)value * resolution / 1000);
+}
+
+static string data_str(const trace_record& rec, const char* sep) {
+    string s;
+    size_t n = min<size_t>(rec.size, sizeof(rec.data));
+    for (size_t i = 0; i < n; i++) {
+        char buf[4];
+        snprintf(buf, sizeof(buf), "%02x", rec.data[i]);
+        if (i > 0)
+            s += sep;
+        s += buf;
+    }
+
+    if (rec.size > sizeof(rec.data))
+        s += string(sep) + "...";
+
+    return s;
+}
+
+// uses the logger's own formatting, so that text dumps can be diffed
+// against regular trace logs
+static void print_text(FILE* out, const trace_record& rec, const string& name,
+                       u64 resolution) {
+    trace_direction dir = rec.kind == TRACE_RECORD_FW ? TRACE_FW : TRACE_BW;
+    if (rec.flags & TRACE_FLAG_NOINDENT)
+        dir = dir == TRACE_FW ? TRACE_FW_NOINDENT : TRACE_BW_NOINDENT;
+
+    u8 data[sizeof(rec.data)];
+    unsigned int size = min<size_t>(rec.size, sizeof(rec.data));
+    memcpy(data, rec.data, size);
+
+    tlm_generic_payload tx;
+    tx.set_command((tlm_command)rec.command);
+    tx.set_address(rec.addr);
+    tx.set_data_ptr(data);
+    tx.set_data_length(size);
+    tx.set_streaming_width(size);
+    tx.set_response_status((tlm_response_status)rec.response);
+
+    logmsg msg(LOG_TRACE, name);
+    msg.time = time_from_value(to_ps(rec.time, resolution));
+    msg.cycle = rec.delta;
+    msg.lines.push_back(logger::trace_prefix(dir) +
+                        tlm_transaction_to_str(tx));
+
+    // only the leading data bytes are recorded in binary traces
+    if (rec.size > sizeof(rec.data))
+        msg.lines.back() += " ...";
+
+    stringstream ss;
+    logger::print_logmsg(ss, msg);
+    fprintf(out, "%s\n", ss.str().c_str());
+}
+
+static void print_csv_header(FILE* out) {
+    fprintf(out, "time_ps,delta,socket,direction,command,address,size,"
+                 "response,latency_ps,cpuid,flags,data\n");
+}
+
+static void print_csv(FILE* out, const trace_record& rec, const string& name,
+                      u64 resolution) {
+    fprintf(out, "%lu,%lu,%s,%s,%s,0x%lx,%u,%s,%lu,%u,0x%02x,%s\n",
+            to_ps(rec.time, resolution), rec.delta, name.c_str(),
+            rec.kind == TRACE_RECORD_FW ? "fw" : "bw",
+            command_str(rec.command), rec.addr, rec.size,
+            response_str(rec.response), to_ps(rec.latency, resolution),
+            rec.cpuid, rec.flags, data_str(rec, " ").c_str());
+}
+
+int main(int argc, char** argv) {
+    const char* input = nullptr;
+    const char* output = nullptr;
+    bool csv = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else if (strcmp(argv[i], "-o") == 0 && i < argc - 1) {
+            output = argv[++i];
+        } else if (input == nullptr && argv[i][0] != '-') {
+            input = argv[i];
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (input == nullptr) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    FILE* in = fopen(input, "rb");
+    if (in == nullptr) {
+        fprintf(stderr, "cannot open %s: %s\n", input, strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    trace_file_header header;
+    if (fread(&header, sizeof(header), 1, in) != 1 ||
+        memcmp(header.magic, TRACE_FORMAT_MAGIC, sizeof(header.magic))) {
+        fprintf(stderr, "%s is not a vcml trace file\n", input);
+        return EXIT_FAILURE;
+    }
+
+    if (header.version != TRACE_FORMAT_VERSION ||
+        header.record_size != sizeof(trace_record)) {
+        fprintf(stderr, "unsupported trace format version %u\n",
+                header.version);
+        return EXIT_FAILURE;
+    }
+
+    FILE* out = output ? fopen(output, "w") : stdout;
+    if (out == nullptr) {
+        fprintf(stderr, "cannot open %s: %s\n", output, strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    if (csv)
+        print_csv_header(out);
+
+    unordered_map<u32, string> names;
+    trace_record rec;
+
+    while (fread(&rec, sizeof(rec), 1, in) == 1) {
+        switch (rec.kind) {
+        case TRACE_RECORD_NAME:
+            names[rec.socket] = string(rec.name,
+                                       strnlen(rec.name, sizeof(rec.name)));
+            break;
+
+        case TRACE_RECORD_NAME_CONT:
+            names[rec.socket] += string(rec.name,
+                                        strnlen(rec.name, sizeof(rec.name)));
+            break;
+
+        case TRACE_RECORD_FW:
+        case TRACE_RECORD_BW:
+            if (csv)
+                print_csv(out, rec, names[rec.socket], header.resolution);
+            else
+                print_text(out, rec, names[rec.socket], header.resolution);
+            break;
+
+        default:
+            fprintf(stderr, "invalid trace record kind %hhu\n", rec.kind);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (out != stdout)
+        fclose(out);
+    fclose(in);
+
+    return EXIT_SUCCESS;
+}